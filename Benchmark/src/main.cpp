@@ -0,0 +1,412 @@
+#include <core.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <numeric>
+#include <atomic>
+#include <new>
+
+// Every heap allocation of the process is counted, cases report how many they made per unit of work
+static std::atomic<size_t> allocationCount = 0;
+
+void* operator new(size_t size) {
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* pointer = malloc(size == 0 ? 1 : size)) return pointer;
+	throw std::bad_alloc();
+}
+void operator delete(void* pointer) noexcept {
+	free(pointer);
+}
+void operator delete(void* pointer, size_t) noexcept {
+	free(pointer);
+}
+
+// Every case runs `warmup` untimed iterations and then `iterations` timed ones, all worlds and random numbers come from `seed`
+// Worlds are generated and meshed on `threads` threads, 0 is one per hardware thread
+struct Policy {
+	int seed = 1337, warmup = 2, iterations = 10;
+	unsigned threads = 0;
+	const char* filter = nullptr;
+};
+
+struct Result {
+	std::string name, unit;
+	size_t units = 0;
+
+	// Nanoseconds per unit, one sample per timed iteration
+	std::vector<double> samples;
+	// Heap allocations per unit, averaged over the timed iterations
+	double allocations = 0.0;
+	std::vector<std::pair<std::string, double>> extras;
+
+	double min() const {
+		return *std::min_element(this->samples.begin(), this->samples.end());
+	}
+	double max() const {
+		return *std::max_element(this->samples.begin(), this->samples.end());
+	}
+	double mean() const {
+		return std::accumulate(this->samples.begin(), this->samples.end(), 0.0) / this->samples.size();
+	}
+	double median() const {
+		std::vector<double> sorted = this->samples;
+		std::sort(sorted.begin(), sorted.end());
+
+		size_t middle = sorted.size() / 2;
+		return sorted.size() % 2 == 0 ? (sorted[middle - 1] + sorted[middle]) * 0.5 : sorted[middle];
+	}
+};
+
+class Suite {
+private:
+	Policy policy;
+	std::vector<Result> results;
+public:
+	Suite(const Policy& policy) : policy(policy) {}
+
+	bool isEnabled(const char* name) const {
+		return this->policy.filter == nullptr || strstr(name, this->policy.filter) != nullptr;
+	}
+
+	// setup(iteration) runs untimed before every iteration, run(iteration) is timed and returns how many units of work it did
+	template<typename Setup, typename Run>
+	Result* measure(const char* name, const char* unit, Setup setup, Run run) {
+		if (!this->isEnabled(name)) return nullptr;
+
+		Result result = { .name = name, .unit = unit };
+		for (int iteration = 0; iteration < this->policy.warmup + this->policy.iterations; iteration++) {
+			setup(iteration);
+
+			size_t allocations = allocationCount.load(std::memory_order_relaxed);
+			auto start = std::chrono::high_resolution_clock::now();
+			size_t units = run(iteration);
+			double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+			allocations = allocationCount.load(std::memory_order_relaxed) - allocations;
+
+			if (iteration < this->policy.warmup) continue;
+
+			result.units = units;
+			result.samples.push_back(nanoseconds / glm::max<size_t>(units, 1));
+			result.allocations += static_cast<double>(allocations) / glm::max<size_t>(units, 1) / this->policy.iterations;
+		}
+
+		fprintf(stderr, "%-24s %14.1f ns per %s (min %.1f, max %.1f), %.2f allocations\n", name, result.median(), unit, result.min(), result.max(), result.allocations);
+
+		this->results.push_back(result);
+		return &this->results.back();
+	}
+
+	void write(FILE* file) const {
+		fprintf(file, "{\n");
+		fprintf(file, "\t\"seed\": %d,\n", this->policy.seed);
+		fprintf(file, "\t\"warmup\": %d,\n", this->policy.warmup);
+		fprintf(file, "\t\"iterations\": %d,\n", this->policy.iterations);
+		fprintf(file, "\t\"threads\": %u,\n", this->policy.threads);
+		fprintf(file, "\t\"results\": [");
+
+		for (size_t i = 0; i < this->results.size(); i++) {
+			const Result& result = this->results[i];
+
+			fprintf(file, i == 0 ? "\n" : ",\n");
+			fprintf(file, "\t\t{\n");
+			fprintf(file, "\t\t\t\"name\": \"%s\",\n", result.name.c_str());
+			fprintf(file, "\t\t\t\"unit\": \"%s\",\n", result.unit.c_str());
+			fprintf(file, "\t\t\t\"units\": %zu,\n", result.units);
+			fprintf(file, "\t\t\t\"ns\": { \"min\": %.3f, \"median\": %.3f, \"mean\": %.3f, \"max\": %.3f },\n", result.min(), result.median(), result.mean(), result.max());
+			fprintf(file, "\t\t\t\"allocations\": %.3f", result.allocations);
+
+			if (!result.extras.empty()) {
+				fprintf(file, ",\n\t\t\t\"extra\": {");
+				for (size_t j = 0; j < result.extras.size(); j++) {
+					fprintf(file, "%s \"%s\": %.3f", j == 0 ? "" : ",", result.extras[j].first.c_str(), result.extras[j].second);
+				}
+				fprintf(file, " }");
+			}
+
+			fprintf(file, "\n\t\t}");
+		}
+
+		fprintf(file, "\n\t]\n}\n");
+	}
+};
+
+static const size_t CHUNK_COUNT = ChunkGenerator::CHUNKS_X * ChunkGenerator::CHUNKS_Y * ChunkGenerator::CHUNKS_Z;
+
+// Takes and frees every built mesh, returns their vertex count
+static size_t dropMeshes(ChunkGenerator& chunkGenerator) {
+	uint32_t id;
+	ChunkMeshData data;
+
+	size_t vertices = 0;
+	while (chunkGenerator.takeMesh(id, data)) {
+		vertices += data.getVertexCount();
+	}
+
+	return vertices;
+}
+
+static void generation(Suite& suite, const Policy& policy) {
+	std::unique_ptr<ChunkGenerator> chunkGenerator;
+
+	for (bool useColumnCache : { true, false }) {
+		Result* result = suite.measure(
+			useColumnCache ? "chunk_create" : "chunk_create_uncached", "chunk",
+			[&](int) { chunkGenerator = std::make_unique<ChunkGenerator>(policy.seed, 1, policy.threads); },
+			[&](int) { chunkGenerator->create(useColumnCache); return CHUNK_COUNT; }
+		);
+		if (result == nullptr) continue;
+
+		// Stage breakdown of the last iteration
+		TerrainTimings timings = chunkGenerator->getTimings() / static_cast<double>(CHUNK_COUNT);
+		result->extras = {
+			{ "heightmap_ns", timings.heightmap * 1e6 },
+			{ "biome_blend_ns", timings.biomeBlend * 1e6 },
+			{ "surface_ns", timings.surface * 1e6 },
+			{ "carvers_ns", timings.carvers * 1e6 }
+		};
+	}
+
+	// Terrain and meshes together, a mesh starts as soon as the columns around it are done
+	suite.measure(
+		"chunk_create_meshed", "chunk",
+		[&](int) { chunkGenerator = std::make_unique<ChunkGenerator>(policy.seed, 1, policy.threads); },
+		[&](int) { chunkGenerator->create(true, true); return CHUNK_COUNT; }
+	);
+}
+
+static void caves(Suite& suite, const Policy& policy) {
+	static const int CHUNKS = 64;
+	FastNoise noise = FastNoise(policy.seed);
+
+	std::vector<std::vector<FN_DECIMAL>> exact(CHUNKS);
+	for (int i = 0; i < CHUNKS; i++) {
+		CaveField::sample(&noise, exact[i], glm::i64vec3(i * Chunk::WIDTH, 0, 0), Chunk::WIDTH, Chunk::HEIGHT, Chunk::LENGTH, 1);
+	}
+
+	for (uint16_t cellSize : { 1, 2, 4, 8 }) {
+		std::string name = cellSize == 1 ? "caves_exact" : "caves_cell_" + std::to_string(cellSize);
+		std::vector<std::vector<FN_DECIMAL>> density(CHUNKS);
+
+		Result* result = suite.measure(
+			name.c_str(), "chunk",
+			[&](int) {},
+			[&](int) {
+				for (int i = 0; i < CHUNKS; i++) {
+					CaveField::sample(&noise, density[i], glm::i64vec3(i * Chunk::WIDTH, 0, 0), Chunk::WIDTH, Chunk::HEIGHT, Chunk::LENGTH, cellSize);
+				}
+				return static_cast<size_t>(CHUNKS);
+			}
+		);
+		if (result == nullptr) continue;
+
+		size_t mismatches = 0, total = 0;
+		for (int i = 0; i < CHUNKS; i++) {
+			for (size_t j = 0; j < exact[i].size(); j++) {
+				mismatches += (exact[i][j] <= CaveField::THRESHOLD) != (density[i][j] <= CaveField::THRESHOLD);
+				total++;
+			}
+		}
+		result->extras = { { "mismatch_percent", 100.0 * mismatches / total } };
+	}
+}
+
+static void meshing(Suite& suite, ChunkGenerator& chunkGenerator) {
+	// Full detail one quad per face and greedy, then every level of detail (greedy, like in game) for all chunks at once
+	struct Case {
+		std::string name;
+		bool greedy;
+		uint8_t lod;
+	};
+	std::vector<Case> cases = { { "mesh_create", false, 0 }, { "mesh_create_greedy", true, 0 } };
+	for (uint8_t lod = 1; lod <= ChunkMesh::MAX_LOD; lod++) {
+		cases.push_back({ "mesh_create_lod" + std::to_string(lod), true, lod });
+	}
+
+	for (const Case& meshCase : cases) {
+		chunkGenerator.setGreedyMeshing(meshCase.greedy);
+		for (size_t i = 0; i < CHUNK_COUNT; i++) {
+			chunkGenerator.chunkMeshes[i].setLod(meshCase.lod);
+		}
+
+		Result* result = suite.measure(
+			meshCase.name.c_str(), "chunk",
+			[&](int) {
+				dropMeshes(chunkGenerator);
+				for (size_t i = 0; i < CHUNK_COUNT; i++) {
+					chunkGenerator.markMeshDirty(i);
+				}
+			},
+			[&](int) { chunkGenerator.updateMeshes(); return CHUNK_COUNT; }
+		);
+
+		// Size of the geometry the last iteration built
+		size_t vertices = dropMeshes(chunkGenerator);
+		if (result != nullptr) result->extras = { { "vertices", static_cast<double>(vertices) }, { "bytes", static_cast<double>(vertices * sizeof(uint32_t)) } };
+	}
+
+	chunkGenerator.setGreedyMeshing(false);
+	chunkGenerator.setLodEnabled(false);
+	chunkGenerator.updateMeshes();
+	dropMeshes(chunkGenerator);
+}
+
+static void blockAccess(Suite& suite, ChunkGenerator& chunkGenerator) {
+	static const uint32_t SIZE_X = ChunkGenerator::CHUNKS_X * Chunk::WIDTH, SIZE_Y = ChunkGenerator::CHUNKS_Y * Chunk::HEIGHT, SIZE_Z = ChunkGenerator::CHUNKS_Z * Chunk::LENGTH;
+	static const uint32_t EDIT_SIZE = 64;
+
+	volatile uint64_t sink = 0;
+	suite.measure(
+		"get_block", "call",
+		[&](int) {},
+		[&](int) {
+			uint64_t sum = 0;
+			for (uint32_t y = 0; y < SIZE_Y; y++) {
+				for (uint32_t z = 0; z < SIZE_Z; z++) {
+					for (uint32_t x = 0; x < SIZE_X; x++) {
+						sum += chunkGenerator.getBlock(x, y, z);
+					}
+				}
+			}
+
+			sink = sink + sum;
+			return static_cast<size_t>(SIZE_X) * SIZE_Y * SIZE_Z;
+		}
+	);
+
+	// A cube around the surface, alternating between stone and dirt so every call changes a block
+	suite.measure(
+		"set_block", "call",
+		[&](int) {},
+		[&](int iteration) {
+			uint8_t block = iteration % 2 == 0 ? 2 : 4;
+			for (uint32_t y = 48; y < 48 + EDIT_SIZE; y++) {
+				for (uint32_t z = 128; z < 128 + EDIT_SIZE; z++) {
+					for (uint32_t x = 128; x < 128 + EDIT_SIZE; x++) {
+						chunkGenerator.setBlock(x, y, z, block);
+					}
+				}
+			}
+
+			return static_cast<size_t>(EDIT_SIZE) * EDIT_SIZE * EDIT_SIZE;
+		}
+	);
+}
+
+static void collision(Suite& suite, const Policy& policy, ChunkGenerator& chunkGenerator) {
+	static const int BOXES = 4096;
+	static const glm::vec3 SCALE = glm::vec3(0.5f, 1.82f, 0.5f);
+
+	// Player sized boxes standing on the terrain, each one walks and falls for one 60 FPS frame
+	std::mt19937 random(policy.seed);
+	std::vector<glm::vec3> positions;
+
+	while (positions.size() < BOXES) {
+		uint32_t x = 1 + random() % (ChunkGenerator::CHUNKS_X * Chunk::WIDTH - 2);
+		uint32_t z = 1 + random() % (ChunkGenerator::CHUNKS_Z * Chunk::LENGTH - 2);
+
+		for (uint32_t y = ChunkGenerator::CHUNKS_Y * Chunk::HEIGHT - 1; y > 0; y--) {
+			if (chunkGenerator.getBlock(x, y, z) != 0) {
+				positions.push_back(glm::vec3(x + 0.25f, y + 1.01f, z + 0.25f));
+				break;
+			}
+		}
+	}
+
+	glm::vec3 motion = glm::vec3(4.0f, -10.0f, 3.0f) / 60.0f;
+	volatile float sink = 0.0f;
+
+	suite.measure(
+		"collision_move", "call",
+		[&](int) {},
+		[&](int) {
+			float sum = 0.0f;
+			for (const glm::vec3& start : positions) {
+				glm::vec3 position = start;
+				sum += Collision::move(chunkGenerator, position, SCALE, motion).y;
+			}
+
+			sink = sink + sum;
+			return positions.size();
+		}
+	);
+}
+
+static void blobs(Suite& suite, const Policy& policy, ChunkGenerator& chunkGenerator) {
+	static const int BLOBS = 4;
+	std::mt19937 random(policy.seed);
+
+	// The same edit the right mouse button does in game, including rebuilding the touched meshes
+	suite.measure(
+		"blob_edit", "blob",
+		[&](int) { dropMeshes(chunkGenerator); },
+		[&](int) {
+			for (int i = 0; i < BLOBS; i++) {
+				int x = random() % (ChunkGenerator::CHUNKS_X * Chunk::WIDTH);
+				int y = random() % (ChunkGenerator::CHUNKS_Y * Chunk::HEIGHT);
+				int z = random() % (ChunkGenerator::CHUNKS_Z * Chunk::LENGTH);
+
+				chunkGenerator.createBlob(x, y, z, 0, 16, &random);
+			}
+
+			chunkGenerator.updateMeshes();
+			return static_cast<size_t>(BLOBS);
+		}
+	);
+	dropMeshes(chunkGenerator);
+}
+
+int main(int argc, char** argv) {
+	Policy policy;
+	const char* output = nullptr;
+
+	for (int i = 1; i < argc; i++) {
+		bool hasValue = i + 1 < argc;
+
+		if (hasValue && strcmp(argv[i], "--seed") == 0) policy.seed = atoi(argv[++i]);
+		else if (hasValue && strcmp(argv[i], "--warmup") == 0) policy.warmup = glm::max(atoi(argv[++i]), 0);
+		else if (hasValue && strcmp(argv[i], "--iterations") == 0) policy.iterations = glm::max(atoi(argv[++i]), 1);
+		else if (hasValue && strcmp(argv[i], "--threads") == 0) policy.threads = static_cast<unsigned>(glm::max(atoi(argv[++i]), 0));
+		else if (hasValue && strcmp(argv[i], "--filter") == 0) policy.filter = argv[++i];
+		else if (hasValue && strcmp(argv[i], "--output") == 0) output = argv[++i];
+		else {
+			fprintf(stderr, "Usage: %s [--seed N] [--warmup N] [--iterations N] [--threads N] [--filter NAME] [--output FILE]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	Blocks::registerDefaults();
+	Suite suite = Suite(policy);
+
+	generation(suite, policy);
+	caves(suite, policy);
+
+	// The remaining cases share one world, block edits run last since they change it
+	std::unique_ptr<ChunkGenerator> chunkGenerator = std::make_unique<ChunkGenerator>(policy.seed, 1, policy.threads);
+	chunkGenerator->create();
+	chunkGenerator->updateMeshes();
+	dropMeshes(*chunkGenerator);
+
+	meshing(suite, *chunkGenerator);
+	collision(suite, policy, *chunkGenerator);
+	blockAccess(suite, *chunkGenerator);
+	blobs(suite, policy, *chunkGenerator);
+
+	FILE* file = output == nullptr ? stdout : fopen(output, "w");
+	if (file == nullptr) {
+		fprintf(stderr, "Failed to open %s\n", output);
+		return 1;
+	}
+
+	suite.write(file);
+	if (file != stdout) fclose(file);
+
+	return 0;
+}
@@ -0,0 +1,20 @@
+#pragma once
+// Headless part of MineStorm: voxel storage, terrain generation, CPU meshing and collision
+// Nothing in here depends on OpenGL, GLFW or Brainstorm
+#include "noise/FastNoise.h"
+
+#include "world/block.h"
+#include "world/terrain.h"
+#include "world/chunk.h"
+#include "world/generator.h"
+#include "world/collision.h"
+#include "world/worldhashes.h"
+
+#include "mesh/chunkmesh.h"
+#include "mesh/vertexarena.h"
+#include "mesh/drawcommands.h"
+#include "mesh/frustum.h"
+#include "mesh/uploadscheduler.h"
+
+#include "jobs/jobsystem.h"
+#include "jobs/spscqueue.h"
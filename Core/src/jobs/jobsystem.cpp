@@ -0,0 +1,142 @@
+#include "jobsystem.h"
+
+#include <algorithm>
+
+JobSystem::JobSystem(unsigned threadCount) {
+	if (threadCount == 0) threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+	for (unsigned i = 0; i < threadCount; i++) {
+		this->workers.push_back(std::make_unique<Worker>());
+	}
+	for (unsigned i = 1; i < threadCount; i++) {
+		this->threads.emplace_back(&JobSystem::work, this, i);
+	}
+}
+JobSystem::~JobSystem() {
+	{
+		std::lock_guard<std::mutex> lock(this->sleepMutex);
+		this->stopping = true;
+	}
+	this->wakeup.notify_all();
+
+	for (std::thread& thread : this->threads) {
+		thread.join();
+	}
+}
+
+void JobSystem::push(size_t worker, uint32_t job) {
+	// Counted before it can be taken, so queued never drops below the jobs actually in the deques
+	this->queued++;
+	{
+		std::lock_guard<std::mutex> lock(this->workers[worker]->mutex);
+		this->workers[worker]->jobs.push_back(job);
+	}
+
+	// Taking the sleep mutex orders the new count before any thread that is about to sleep checks it
+	{
+		std::lock_guard<std::mutex> lock(this->sleepMutex);
+	}
+	this->wakeup.notify_one();
+}
+
+bool JobSystem::pop(size_t worker, uint32_t& job) {
+	if (this->queued == 0) return false;
+
+	// Own deque from the back, then the others from the front
+	for (size_t i = 0; i < this->workers.size(); i++) {
+		Worker& victim = *this->workers[(worker + i) % this->workers.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (victim.jobs.empty()) continue;
+
+		if (i == 0) {
+			job = victim.jobs.back();
+			victim.jobs.pop_back();
+		}
+		else {
+			job = victim.jobs.front();
+			victim.jobs.pop_front();
+		}
+
+		this->queued--;
+		return true;
+	}
+
+	return false;
+}
+
+void JobSystem::execute(size_t worker, uint32_t job) {
+	this->graph->jobs[job].work();
+
+	for (uint32_t dependent : this->graph->jobs[job].dependents) {
+		if (--this->waiting[dependent] == 0) this->push(worker, dependent);
+	}
+
+	if (--this->unfinished == 0) {
+		{
+			std::lock_guard<std::mutex> lock(this->sleepMutex);
+		}
+		this->wakeup.notify_all();
+	}
+}
+
+void JobSystem::work(size_t worker) {
+	while (true) {
+		uint32_t job;
+		if (this->pop(worker, job)) {
+			this->execute(worker, job);
+
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(this->sleepMutex);
+		this->wakeup.wait(lock, [this]() { return this->queued > 0 || this->stopping; });
+		if (this->stopping) return;
+	}
+}
+
+void JobSystem::run(JobGraph& graph) {
+	if (graph.empty()) return;
+
+	this->graph = &graph;
+	this->waiting = std::make_unique<std::atomic<uint32_t>[]>(graph.jobs.size());
+	this->unfinished = graph.jobs.size();
+
+	// All counters are set before the first push, a running job may already count down the dependents of jobs after it
+	for (uint32_t job = 0; job < graph.jobs.size(); job++) {
+		this->waiting[job] = graph.jobs[job].dependencies;
+	}
+
+	// Jobs without dependencies are dealt out to all threads, so they start without stealing
+	// Each deque is filled at once and last job first, a thread pops its newest job first and so starts them in the order they were added
+	std::vector<uint32_t> roots;
+	for (uint32_t job = 0; job < graph.jobs.size(); job++) {
+		if (graph.jobs[job].dependencies == 0) roots.push_back(job);
+	}
+
+	this->queued += roots.size();
+	for (size_t worker = 0; worker < this->workers.size(); worker++) {
+		std::lock_guard<std::mutex> lock(this->workers[worker]->mutex);
+
+		for (size_t i = roots.size(); i-- > 0;) {
+			if (i % this->workers.size() == worker) this->workers[worker]->jobs.push_back(roots[i]);
+		}
+	}
+	{
+		std::lock_guard<std::mutex> lock(this->sleepMutex);
+	}
+	this->wakeup.notify_all();
+
+	while (this->unfinished > 0) {
+		uint32_t job;
+		if (this->pop(0, job)) {
+			this->execute(0, job);
+
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(this->sleepMutex);
+		this->wakeup.wait(lock, [this]() { return this->queued > 0 || this->unfinished == 0; });
+	}
+
+	this->graph = nullptr;
+}
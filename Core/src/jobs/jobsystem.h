@@ -0,0 +1,88 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+// Jobs and the jobs each of them waits for, built up front and then run by a JobSystem
+class JobGraph {
+private:
+	friend class JobSystem;
+
+	struct Job {
+		std::function<void()> work;
+		std::vector<uint32_t> dependents;
+		uint32_t dependencies = 0;
+	};
+	std::vector<Job> jobs;
+public:
+	// dependencies are ids returned by earlier add() calls, the job starts once all of them have finished
+	uint32_t add(std::function<void()> work, const std::vector<uint32_t>& dependencies = {}) {
+		uint32_t id = static_cast<uint32_t>(this->jobs.size());
+		this->jobs.push_back({ .work = std::move(work), .dependents = {}, .dependencies = static_cast<uint32_t>(dependencies.size()) });
+
+		for (uint32_t dependency : dependencies) {
+			this->jobs[dependency].dependents.push_back(id);
+		}
+
+		return id;
+	}
+
+	size_t size() const {
+		return this->jobs.size();
+	}
+	bool empty() const {
+		return this->jobs.empty();
+	}
+};
+
+// Runs job graphs on a fixed set of threads, the thread calling run() is one of them
+// Every thread has its own deque of ready jobs: it takes its newest job first (a job it just unlocked, whose data is likely still in cache)
+// and when its deque is empty steals the oldest job of another thread, threads without any work sleep until a job becomes ready
+class JobSystem {
+private:
+	struct Worker {
+		std::mutex mutex;
+		std::deque<uint32_t> jobs;
+	};
+
+	// workers[0] belongs to the thread calling run(), workers[i] to threads[i - 1]
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::vector<std::thread> threads;
+
+	// The graph being run, dependencies left per job and jobs left in total
+	JobGraph* graph = nullptr;
+	std::unique_ptr<std::atomic<uint32_t>[]> waiting;
+	std::atomic<size_t> unfinished = 0;
+
+	// Ready jobs in all deques, threads sleep on wakeup while there are none
+	std::atomic<size_t> queued = 0;
+	std::mutex sleepMutex;
+	std::condition_variable wakeup;
+	bool stopping = false;
+
+	void push(size_t worker, uint32_t job);
+	bool pop(size_t worker, uint32_t& job);
+	void execute(size_t worker, uint32_t job);
+	void work(size_t worker);
+public:
+	// 0 threads uses one per hardware thread, 1 runs every job on the thread calling run()
+	JobSystem(unsigned threadCount = 0);
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	// Runs every job of graph and returns once all of them have finished, only one run() at a time
+	// Jobs without dependencies start roughly in the order they were added (a thread out of work steals the last ones), so add urgent ones first
+	void run(JobGraph& graph);
+
+	unsigned getThreadCount() const {
+		return static_cast<unsigned>(this->workers.size());
+	}
+};
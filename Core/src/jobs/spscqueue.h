@@ -0,0 +1,44 @@
+#pragma once
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+// A bounded ring buffer for exactly one thread pushing and one other thread popping, without locks
+// Each side only writes its own index and reads the other one with acquire, so a popped slot is always completely written
+template<typename T>
+class SpscQueue {
+private:
+	// One slot always stays free, head == tail is empty
+	std::vector<T> slots;
+
+	// Next slot to pop, written by the consumer, and next slot to push, written by the producer, on their own cache lines
+	alignas(64) std::atomic<size_t> head = 0;
+	alignas(64) std::atomic<size_t> tail = 0;
+public:
+	SpscQueue(size_t capacity) : slots(capacity + 1) {}
+
+	SpscQueue(const SpscQueue&) = delete;
+	SpscQueue& operator=(const SpscQueue&) = delete;
+
+	// Producer only, returns false when the queue is full
+	bool push(const T& value) {
+		size_t tail = this->tail.load(std::memory_order_relaxed);
+		size_t next = tail + 1 == this->slots.size() ? 0 : tail + 1;
+		if (next == this->head.load(std::memory_order_acquire)) return false;
+
+		this->slots[tail] = value;
+		this->tail.store(next, std::memory_order_release);
+
+		return true;
+	}
+	// Consumer only, returns false when the queue is empty
+	bool pop(T& value) {
+		size_t head = this->head.load(std::memory_order_relaxed);
+		if (head == this->tail.load(std::memory_order_acquire)) return false;
+
+		value = std::move(this->slots[head]);
+		this->head.store(head + 1 == this->slots.size() ? 0 : head + 1, std::memory_order_release);
+
+		return true;
+	}
+};
@@ -0,0 +1,313 @@
+#include "chunkmesh.h"
+
+#include <algorithm>
+#include <bit>
+
+// Top, bottom, right, left, front, back
+const ChunkMesh::Direction ChunkMesh::DIRECTIONS[6] = {
+	{ glm::ivec3(0, 1, 0), glm::ivec3(1, 0, 0), glm::ivec3(0, 0, -1), glm::ivec3(0, 1, 1), &Block::top },
+	{ glm::ivec3(0, -1, 0), glm::ivec3(1, 0, 0), glm::ivec3(0, 0, 1), glm::ivec3(0, 0, 0), &Block::bottom },
+	{ glm::ivec3(1, 0, 0), glm::ivec3(0, 0, -1), glm::ivec3(0, 1, 0), glm::ivec3(1, 0, 1), &Block::right },
+	{ glm::ivec3(-1, 0, 0), glm::ivec3(0, 0, 1), glm::ivec3(0, 1, 0), glm::ivec3(0, 0, 0), &Block::left },
+	{ glm::ivec3(0, 0, 1), glm::ivec3(1, 0, 0), glm::ivec3(0, 1, 0), glm::ivec3(0, 0, 1), &Block::front },
+	{ glm::ivec3(0, 0, -1), glm::ivec3(-1, 0, 0), glm::ivec3(0, 1, 0), glm::ivec3(1, 0, 0), &Block::back }
+};
+
+static inline int getAxis(const glm::ivec3& direction) {
+	return direction.x != 0 ? 0 : direction.y != 0 ? 1 : 2;
+}
+static inline int getOffset(const glm::ivec3& position, const glm::ivec3& steps) {
+	return position.x * steps.x + position.y * steps.y + position.z * steps.z;
+}
+
+uint32_t* ChunkMesh::addQuad(uint32_t* vertices, int side, const glm::ivec3& corner, int width, int height, uint32_t face) {
+	// Texture space corners in QUAD_INDICES order, its triangles share the (1, 0) - (0, 1) diagonal
+	// The second order starts one corner later so the same indices split the quad along (0, 0) - (1, 1) instead
+	static const int CORNERS[2][4][2] = {
+		{ { 0, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 } },
+		{ { 1, 0 }, { 1, 1 }, { 0, 0 }, { 0, 1 } }
+	};
+
+	const Direction& direction = ChunkMesh::DIRECTIONS[side];
+	glm::u8vec2 tile = glm::u8vec2((face >> 8) & 0xF, (face >> 12) & 0xF);
+
+	// Ambient occlusion is interpolated per triangle, splitting along the diagonal whose corners are darker together
+	// keeps a single occluded corner from shading only half of the quad
+	uint32_t a00 = face & 3, a10 = (face >> 2) & 3, a01 = (face >> 4) & 3, a11 = (face >> 6) & 3;
+	bool flipped = a00 + a11 > a10 + a01;
+
+	for (const int* texcoord : CORNERS[flipped]) {
+		*vertices++ = ChunkVertex::pack({
+			.position = glm::u8vec3(corner + direction.u * (texcoord[0] * width) + direction.v * (texcoord[1] * height)),
+			.side = static_cast<uint8_t>(side),
+			.ambient = static_cast<uint8_t>((face >> ((texcoord[0] + texcoord[1] * 2) * 2)) & 3),
+			.tile = tile
+		});
+	}
+
+	return vertices;
+}
+
+void ChunkMesh::fillPadded(const ChunkNeighbors& neighbors, uint8_t* padded) {
+	const glm::ivec3 size = glm::ivec3(Chunk::WIDTH, Chunk::HEIGHT, Chunk::LENGTH);
+
+	for (int offsetY = -1; offsetY <= 1; offsetY++) {
+		for (int offsetZ = -1; offsetZ <= 1; offsetZ++) {
+			for (int offsetX = -1; offsetX <= 1; offsetX++) {
+				glm::ivec3 offset = glm::ivec3(offsetX, offsetY, offsetZ);
+				const ChunkSnapshot& source = neighbors.at(offsetX, offsetY, offsetZ);
+
+				// The part of source that borders the chunk: all of it along axes the offset is 0 on, else its first or last layer
+				glm::ivec3 from = glm::ivec3(offset.x < 0 ? size.x - 1 : 0, offset.y < 0 ? size.y - 1 : 0, offset.z < 0 ? size.z - 1 : 0);
+				glm::ivec3 to = glm::ivec3(offset.x == 0 ? size.x : from.x + 1, offset.y == 0 ? size.y : from.y + 1, offset.z == 0 ? size.z : from.z + 1);
+				glm::ivec3 target = from + offset * size + 1;
+
+				for (int y = from.y; y < to.y; y++) {
+					for (int z = from.z; z < to.z; z++) {
+						uint8_t* row = padded + INDEX_FROM_XYZ(target.x, target.y + y - from.y, target.z + z - from.z, ChunkMesh::PADDED_WIDTH, ChunkMesh::PADDED_LENGTH);
+
+						if (source.isUniform()) memset(row, source.getUniformBlock(), to.x - from.x);
+						else memcpy(row, source.getBlocks() + INDEX_FROM_XYZ(from.x, y, z, Chunk::WIDTH, Chunk::LENGTH), to.x - from.x);
+					}
+				}
+			}
+		}
+	}
+}
+
+// A cell is solid when at least half its voxels are and takes the block of its highest solid voxel, so surfaces keep their top block
+static inline uint8_t getCellBlock(const uint8_t* blocks, const glm::ivec3& origin, int scale) {
+	int solid = 0;
+	uint8_t block = 0;
+
+	for (int y = origin.y + scale - 1; y >= origin.y; y--) {
+		for (int z = origin.z; z < origin.z + scale; z++) {
+			for (int x = origin.x; x < origin.x + scale; x++) {
+				uint8_t voxel = blocks[INDEX_FROM_XYZ(x, y, z, Chunk::WIDTH, Chunk::LENGTH)];
+				if (voxel == 0) continue;
+
+				if (block == 0) block = voxel;
+				solid++;
+			}
+		}
+	}
+
+	return solid * 2 >= scale * scale * scale ? block : 0;
+}
+
+void ChunkMesh::downsample(const ChunkNeighbors& neighbors, uint8_t lod, uint8_t* padded) {
+	const glm::ivec3 chunkSize = glm::ivec3(Chunk::WIDTH, Chunk::HEIGHT, Chunk::LENGTH);
+	const glm::ivec3 paddedSize = (chunkSize >> static_cast<int>(lod)) + 2;
+	const int scale = 1 << lod;
+
+	for (int y = 0; y < paddedSize.y; y++) {
+		for (int z = 0; z < paddedSize.z; z++) {
+			for (int x = 0; x < paddedSize.x; x++) {
+				// First voxel of the cell in chunk space, cells of the border lie in a neighbor
+				glm::ivec3 origin = (glm::ivec3(x, y, z) - 1) * scale;
+				glm::ivec3 offset = glm::ivec3(
+					origin.x < 0 ? -1 : origin.x >= chunkSize.x ? 1 : 0,
+					origin.y < 0 ? -1 : origin.y >= chunkSize.y ? 1 : 0,
+					origin.z < 0 ? -1 : origin.z >= chunkSize.z ? 1 : 0
+				);
+				const ChunkSnapshot& source = neighbors.at(offset.x, offset.y, offset.z);
+				uint8_t& cell = padded[INDEX_FROM_XYZ(x, y, z, paddedSize.x, paddedSize.z)];
+
+				if (source.isUniform()) cell = source.getUniformBlock();
+				else cell = getCellBlock(source.getBlocks(), origin - offset * chunkSize, scale);
+			}
+		}
+	}
+}
+
+void ChunkMesh::create(const ChunkNeighbors& neighbors, bool greedy, uint8_t lod) {
+	this->vertices.clear();
+
+	// Uniform chunks: air has no faces, solid ones surrounded by solid neighbors neither
+	const ChunkSnapshot& chunk = neighbors.at(0, 0, 0);
+	if (chunk.isUniform()) {
+		bool enclosed = true;
+		for (const ChunkSnapshot* neighbor : { &neighbors.at(1, 0, 0), &neighbors.at(-1, 0, 0), &neighbors.at(0, 0, 1), &neighbors.at(0, 0, -1), &neighbors.at(0, 1, 0), &neighbors.at(0, -1, 0) }) {
+			enclosed = enclosed && neighbor->isUniform() && neighbor->getUniformBlock() != 0;
+		}
+
+		if (chunk.getUniformBlock() == 0 || enclosed) return;
+	}
+
+	static const size_t VOLUME = Chunk::WIDTH * Chunk::HEIGHT * Chunk::LENGTH;
+	static const int MAX_LAYERS = std::max({ Chunk::WIDTH, Chunk::HEIGHT, Chunk::LENGTH });
+	static const int COLUMNS = std::max({ ChunkMesh::PADDED_HEIGHT * ChunkMesh::PADDED_LENGTH, ChunkMesh::PADDED_WIDTH * ChunkMesh::PADDED_LENGTH, ChunkMesh::PADDED_WIDTH * ChunkMesh::PADDED_HEIGHT });
+	// Cells of the chosen level of detail, scale voxels along each axis
+	const glm::ivec3 size = glm::ivec3(Chunk::WIDTH, Chunk::HEIGHT, Chunk::LENGTH) >> static_cast<int>(lod);
+	const glm::ivec3 paddedSize = size + 2;
+	const int scale = 1 << lod;
+
+	thread_local std::vector<uint8_t> padded = std::vector<uint8_t>(ChunkMesh::PADDED_WIDTH * ChunkMesh::PADDED_HEIGHT * ChunkMesh::PADDED_LENGTH);
+	// The visible faces of every side, one slice of u * v faces per layer along the normal
+	// Meshing a slice zeroes it again, so the buffer is only cleared when it is first made
+	thread_local std::vector<uint32_t> faces = std::vector<uint32_t>(6 * VOLUME);
+	// Occupancy of every padded column along x, y and z, bit i set when voxel i of the column is solid
+	// Columns along an axis are indexed by the other two padded coordinates, lower axis first (x + z * width for columns along y)
+	thread_local std::vector<uint64_t> columns = std::vector<uint64_t>(3 * COLUMNS);
+	// Bit i of a row is set when slice cell (i, row) has a face, so meshing only visits those cells (and zeroes the rows again)
+	thread_local std::vector<uint64_t> rows = std::vector<uint64_t>(6 * MAX_LAYERS * MAX_LAYERS);
+	// Quads are written here first, it only grows until it fits the biggest mesh its thread has built
+	thread_local std::vector<uint32_t> staging;
+
+	// Visible faces per side and layer, empty slices are skipped and the total bounds the quad count
+	uint16_t layerFaces[6][MAX_LAYERS] = {};
+	size_t faceCount = 0;
+
+	if (lod == 0) ChunkMesh::fillPadded(neighbors, padded.data());
+	else ChunkMesh::downsample(neighbors, lod, padded.data());
+
+	// Distance between neighboring cells of the padded chunk along x, y and z
+	const glm::ivec3 paddedSteps = glm::ivec3(1, paddedSize.x * paddedSize.z, paddedSize.x);
+
+	// Per side: the axes of normal, u and v, the block of slice cell (0, 0)
+	// and padded offsets from a voxel to the one in front of its face and along u and v
+	glm::ivec3 axes[6], starts[6];
+	int normalOffsets[6], uOffsets[6], vOffsets[6];
+
+	for (int side = 0; side < 6; side++) {
+		const Direction& direction = ChunkMesh::DIRECTIONS[side];
+		glm::ivec3& axis = axes[side] = glm::ivec3(getAxis(direction.normal), getAxis(direction.u), getAxis(direction.v));
+		int width = size[axis.y], height = size[axis.z];
+
+		normalOffsets[side] = getOffset(direction.normal, paddedSteps);
+		uOffsets[side] = getOffset(direction.u, paddedSteps);
+		vOffsets[side] = getOffset(direction.v, paddedSteps);
+
+		// u and v may run backwards along their axis
+		starts[side] = glm::ivec3();
+		if (direction.u[axis.y] < 0) starts[side][axis.y] = width - 1;
+		if (direction.v[axis.z] < 0) starts[side][axis.z] = height - 1;
+	}
+
+	std::fill(columns.begin(), columns.end(), 0);
+	uint64_t* columnsX = &columns[0], * columnsY = &columns[COLUMNS], * columnsZ = &columns[2 * COLUMNS];
+
+	for (int y = 0; y < paddedSize.y; y++) {
+		for (int z = 0; z < paddedSize.z; z++) {
+			const uint8_t* row = &padded[INDEX_FROM_XYZ(0, y, z, paddedSize.x, paddedSize.z)];
+			uint64_t* rowY = &columnsY[z * paddedSize.x], * rowZ = &columnsZ[y * paddedSize.x];
+			uint64_t columnX = 0;
+
+			// Plain loops over x with the column along x in a register, so the compiler can vectorize them
+			for (int x = 0; x < paddedSize.x; x++) columnX |= static_cast<uint64_t>(row[x] != 0) << x;
+			for (int x = 0; x < paddedSize.x; x++) rowY[x] |= static_cast<uint64_t>(row[x] != 0) << y;
+			for (int x = 0; x < paddedSize.x; x++) rowZ[x] |= static_cast<uint64_t>(row[x] != 0) << z;
+
+			columnsX[y + z * paddedSize.y] = columnX;
+		}
+	}
+
+	// 32 voxels of a column at a time: a face is visible where a solid voxel has air in front of it,
+	// so only visible faces are visited, and only they read blocks and ambient occlusion
+	for (int side = 0; side < 6; side++) {
+		const Direction& direction = ChunkMesh::DIRECTIONS[side];
+		const glm::ivec3& axis = axes[side];
+		int width = size[axis.y], height = size[axis.z];
+		int normalAxis = axis.x;
+		int columnAxisA = normalAxis == 0 ? 1 : 0, columnAxisB = normalAxis == 2 ? 1 : 2;
+
+		const uint64_t* sideColumns = &columns[normalAxis * COLUMNS];
+		uint64_t layerMask = (1ull << size[normalAxis]) - 1;
+		int u = uOffsets[side], v = vOffsets[side];
+
+		for (int b = 0; b < size[columnAxisB]; b++) {
+			for (int a = 0; a < size[columnAxisA]; a++) {
+				uint64_t column = sideColumns[(a + 1) + (b + 1) * paddedSize[columnAxisA]];
+				// Drop the border bit so bit i is layer i of the chunk
+				uint64_t visible = ((direction.normal[normalAxis] > 0 ? column & ~(column >> 1) : column & ~(column << 1)) >> 1) & layerMask;
+
+				while (visible != 0) {
+					int layer = std::countr_zero(visible);
+					visible &= visible - 1;
+
+					glm::ivec3 position;
+					position[normalAxis] = layer;
+					position[columnAxisA] = a;
+					position[columnAxisB] = b;
+
+					const uint8_t* voxel = &padded[getOffset(position + 1, paddedSteps)];
+					const uint8_t* next = voxel + normalOffsets[side];
+					uint8_t left = next[-u], right = next[u], below = next[-v], above = next[v];
+
+					const BlockFace& blockFace = Blocks::getEntry(*voxel)->*direction.face;
+					uint32_t face = ChunkMesh::FACE_VISIBLE | blockFace.tile.x << 8 | blockFace.tile.y << 12;
+
+					face |= ChunkMesh::buildAmbient(left, below, next[-u - v]);
+					face |= ChunkMesh::buildAmbient(right, below, next[u - v]) << 2;
+					face |= ChunkMesh::buildAmbient(left, above, next[v - u]) << 4;
+					face |= ChunkMesh::buildAmbient(right, above, next[u + v]) << 6;
+
+					// Cell of the face in its slice
+					int i = (position[axis.y] - starts[side][axis.y]) * direction.u[axis.y];
+					int j = (position[axis.z] - starts[side][axis.z]) * direction.v[axis.z];
+
+					faces[side * VOLUME + layer * width * height + i + j * width] = face;
+					rows[(side * MAX_LAYERS + layer) * MAX_LAYERS + j] |= 1ull << i;
+					layerFaces[side][layer]++;
+					faceCount++;
+				}
+			}
+		}
+	}
+
+	if (staging.size() < faceCount * 4) staging.resize(faceCount * 4);
+	uint32_t* vertices = staging.data();
+
+	for (int side = 0; side < 6; side++) {
+		const Direction& direction = ChunkMesh::DIRECTIONS[side];
+		const glm::ivec3& axis = axes[side];
+		int width = size[axis.y], height = size[axis.z];
+
+		for (int layer = 0; layer < size[axis.x]; layer++) {
+			if (layerFaces[side][layer] == 0) continue;
+			uint32_t* slice = &faces[side * VOLUME + layer * width * height];
+			uint64_t* sliceRows = &rows[(side * MAX_LAYERS + layer) * MAX_LAYERS];
+
+			for (int j = 0; j < height; j++) {
+				uint64_t row = sliceRows[j];
+				sliceRows[j] = 0;
+
+				while (row != 0) {
+					int i = std::countr_zero(row);
+					row &= row - 1;
+
+					// Faces already merged into a quad of this or an earlier row are 0
+					uint32_t face = slice[i + j * width];
+					if (face == 0) continue;
+
+					// A quad interpolates its corners, so faces only merge along an axis their ambient occlusion does not change along
+					uint32_t a00 = face & 3, a10 = (face >> 2) & 3, a01 = (face >> 4) & 3, a11 = (face >> 6) & 3;
+					bool mergeU = greedy && a00 == a10 && a01 == a11;
+					bool mergeV = greedy && a00 == a01 && a10 == a11;
+
+					int quadWidth = 1, quadHeight = 1;
+					while (mergeU && i + quadWidth < width && slice[i + quadWidth + j * width] == face) quadWidth++;
+
+					for (bool matches = mergeV; matches && j + quadHeight < height; quadHeight++) {
+						for (int k = i; k < i + quadWidth && matches; k++) {
+							matches = slice[k + (j + quadHeight) * width] == face;
+						}
+						if (!matches) break;
+					}
+
+					for (int v = j; v < j + quadHeight; v++) {
+						std::fill(slice + i + v * width, slice + i + quadWidth + v * width, 0);
+					}
+
+					glm::ivec3 corner = starts[side] + direction.u * i + direction.v * j + direction.origin;
+					corner[axis.x] += layer;
+
+					vertices = ChunkMesh::addQuad(vertices, side, corner * scale, quadWidth * scale, quadHeight * scale, face);
+				}
+			}
+		}
+	}
+
+	// One allocation of the exact size for the geometry that is handed to the renderer
+	this->vertices.assign(staging.data(), vertices);
+}
@@ -0,0 +1,214 @@
+#pragma once
+#include <atomic>
+#include <vector>
+
+#include "../world/block.h"
+#include "../world/chunk.h"
+
+// One chunk mesh vertex packed into 32 bits, decoded again by the terrain vertex shader
+// Bits 0 - 17 hold the position inside the chunk (6 bits per axis, 0 - 32), 18 - 20 the side of the block the face is on (ChunkMesh::DIRECTIONS order),
+// 21 - 22 the ambient occlusion (number of occluders, 0 - 3) and 23 - 30 the atlas tile (4 bits per axis)
+// Texcoords are not stored, the shader projects the position on the texture axes of the side, so greedy quads repeat their tile
+struct ChunkVertex {
+	glm::u8vec3 position = glm::u8vec3();
+	uint8_t side = 0, ambient = 0;
+	glm::u8vec2 tile = glm::u8vec2();
+
+	static const uint32_t POSITION_BITS = 6, SIDE_BITS = 3, AMBIENT_BITS = 2, TILE_BITS = 4;
+	static const uint32_t SIDE_SHIFT = POSITION_BITS * 3, AMBIENT_SHIFT = SIDE_SHIFT + SIDE_BITS, TILE_SHIFT = AMBIENT_SHIFT + AMBIENT_BITS;
+
+	static inline uint32_t pack(const ChunkVertex& vertex) {
+		return vertex.position.x | vertex.position.y << POSITION_BITS | vertex.position.z << POSITION_BITS * 2
+			| vertex.side << SIDE_SHIFT | vertex.ambient << AMBIENT_SHIFT
+			| vertex.tile.x << TILE_SHIFT | vertex.tile.y << (TILE_SHIFT + TILE_BITS);
+	}
+	static inline ChunkVertex unpack(uint32_t packed) {
+		static const uint32_t POSITION_MASK = (1u << POSITION_BITS) - 1, TILE_MASK = (1u << TILE_BITS) - 1;
+
+		return {
+			.position = glm::u8vec3(packed & POSITION_MASK, (packed >> POSITION_BITS) & POSITION_MASK, (packed >> POSITION_BITS * 2) & POSITION_MASK),
+			.side = static_cast<uint8_t>((packed >> SIDE_SHIFT) & ((1u << SIDE_BITS) - 1)),
+			.ambient = static_cast<uint8_t>((packed >> AMBIENT_SHIFT) & ((1u << AMBIENT_BITS) - 1)),
+			.tile = glm::u8vec2((packed >> TILE_SHIFT) & TILE_MASK, (packed >> (TILE_SHIFT + TILE_BITS)) & TILE_MASK)
+		};
+	}
+};
+
+// Geometry of one chunk, four packed vertices per quad
+// Every quad is drawn with the same QUAD_INDICES, so one index buffer made by createIndices() serves all chunks
+struct ChunkMeshData {
+	static constexpr uint32_t QUAD_INDICES[6] = { 0, 1, 2, 3, 2, 1 };
+
+	std::vector<uint32_t> vertices;
+	// ChunkMesh::getVersion() when the build started, older than the current one the geometry is stale
+	uint32_t version = 0;
+
+	size_t getVertexCount() const {
+		return this->vertices.size();
+	}
+	size_t getQuadCount() const {
+		return this->vertices.size() / 4;
+	}
+	size_t getIndexCount() const {
+		return this->getQuadCount() * 6;
+	}
+
+	// QUAD_INDICES repeated for quads quads
+	static std::vector<uint32_t> createIndices(size_t quads) {
+		std::vector<uint32_t> indices = std::vector<uint32_t>(quads * 6);
+		for (size_t i = 0; i < indices.size(); i++) {
+			indices[i] = static_cast<uint32_t>(i / 6 * 4) + ChunkMeshData::QUAD_INDICES[i % 6];
+		}
+
+		return indices;
+	}
+};
+
+// Snapshots of the 3 x 3 x 3 chunks around a chunk (itself in the middle), left empty where there is none, which reads as air
+struct ChunkNeighbors {
+	ChunkSnapshot chunks[27];
+
+	// x, y and z are -1, 0 or 1
+	ChunkSnapshot& at(int x, int y, int z) {
+		return this->chunks[(x + 1) + (y + 1) * 3 + (z + 1) * 9];
+	}
+	const ChunkSnapshot& at(int x, int y, int z) const {
+		return this->chunks[(x + 1) + (y + 1) * 3 + (z + 1) * 9];
+	}
+};
+
+// Builds the geometry of a chunk on the CPU, uploading it is up to the renderer
+class ChunkMesh {
+private:
+	// One side of a block: the outward normal, the axes the texture runs along (u right, v up, seen from outside)
+	// and the corner of the block its (0, 0) texcoord sits on
+	struct Direction {
+		glm::ivec3 normal, u, v, origin;
+		BlockFace Block::* face;
+	};
+	static const Direction DIRECTIONS[6];
+
+	// A visible face packed into 32 bits so faces compare in one instruction: the occluder count (0 - 3) of each corner in bits 0 - 7,
+	// 2 bits per corner, the atlas tile in bits 8 - 15 (4 bits per axis) and bit 16 set, 0 is no face
+	static const uint32_t FACE_VISIBLE = 1u << 16;
+
+	const Chunk* chunk = nullptr;
+	// Settings are changed from other threads than the one meshing, a build reads them once when it starts
+	std::atomic<bool> greedy = false;
+	std::atomic<uint8_t> lod = 0;
+
+	// Every markDirty() counts version up, the mesh is dirty until a build of the latest version is done
+	std::atomic<uint32_t> version = 0;
+	uint32_t builtVersion = 0;
+
+	// The last build, until publish() moves it on
+	std::vector<uint32_t> vertices;
+	bool unpublished = false;
+	// The last published build nobody has taken yet, owned by the mesh
+	std::atomic<ChunkMeshData*> pending = nullptr;
+
+	// The chunk with a one voxel border copied from its neighbors, laid out as INDEX_FROM_XYZ(x + 1, y + 1, z + 1, PADDED_WIDTH, PADDED_LENGTH)
+	// so faces and ambient occlusion read every voxel they need without bounds checks, also across chunk borders
+	static const int PADDED_WIDTH = Chunk::WIDTH + 2, PADDED_HEIGHT = Chunk::HEIGHT + 2, PADDED_LENGTH = Chunk::LENGTH + 2;
+	static void fillPadded(const ChunkNeighbors& neighbors, uint8_t* padded);
+	// fillPadded() for a level of detail above 0: the same layout over cells of 2 ^ lod voxels per axis, (size >> lod) + 2 cells along each axis
+	static void downsample(const ChunkNeighbors& neighbors, uint8_t lod, uint8_t* padded);
+
+	static inline uint32_t buildAmbient(const uint8_t a, const uint8_t b, const uint8_t c) {
+		return (a == 0 ? 0 : 1) + (b == 0 ? 0 : 1) + (c == 0 ? 0 : 1);
+	}
+
+	// Writes the four corners of a width x height face quad to vertices and returns the end, corner is the (0, 0) corner in chunk space
+	static uint32_t* addQuad(uint32_t* vertices, int side, const glm::ivec3& corner, int width, int height, uint32_t face);
+	void create(const ChunkNeighbors& neighbors, bool greedy, uint8_t lod);
+public:
+	// Every face is between a solid block and air, so a chunk has at most half its faces visible (a checkerboard)
+	static const size_t MAX_QUADS = Chunk::WIDTH * Chunk::HEIGHT * Chunk::LENGTH * 3;
+	// Level of detail l merges 2 ^ l voxels along each axis into one
+	static const uint8_t MAX_LOD = 3;
+
+	ChunkMesh() = default;
+	~ChunkMesh() {
+		delete this->pending.load();
+	}
+	ChunkMesh(const ChunkMesh&) = delete;
+	ChunkMesh& operator=(const ChunkMesh&) = delete;
+
+	void connect(const Chunk* chunk) {
+		this->chunk = chunk;
+	}
+	const Chunk* getChunk() const {
+		return this->chunk;
+	}
+
+	// Greedy meshing merges neighboring faces with the same texture into one quad wherever their ambient occlusion allows it
+	void setGreedy(bool greedy) {
+		this->greedy = greedy;
+		this->markDirty();
+	}
+	bool isGreedy() const {
+		return this->greedy;
+	}
+
+	// A cell of 2 ^ lod voxels per axis is solid when at least half its voxels are, with the block of its highest solid voxel
+	void setLod(uint8_t lod) {
+		if (lod > ChunkMesh::MAX_LOD) lod = ChunkMesh::MAX_LOD;
+		if (lod == this->lod) return;
+
+		this->lod = lod;
+		this->markDirty();
+	}
+	uint8_t getLod() const {
+		return this->lod;
+	}
+
+	// neighbors.at(0, 0, 0) is the connected chunk, meshed from the snapshots alone so the chunks can change meanwhile
+	// Leave neighbors meshed at another level of detail empty, faces towards them are then never culled so no holes open at the seam
+	// Only one thread may update a mesh at a time, returns whether it built anything (publish() hands it out)
+	bool update(const ChunkNeighbors& neighbors) {
+		uint32_t version = this->version;
+		if (version == this->builtVersion) return false;
+
+		this->create(neighbors, this->greedy, this->lod);
+		this->builtVersion = version;
+		this->unpublished = true;
+
+		return true;
+	}
+	// Safe from any thread, also while the mesh is being built (it is then built again)
+	void markDirty() {
+		this->version++;
+	}
+	// On the thread that updates the mesh
+	bool isDirty() const {
+		return this->version != this->builtVersion;
+	}
+	uint32_t getVersion() const {
+		return this->version;
+	}
+
+	// Moves the last build to the slot take() reads, replacing a build that was not taken yet, on the thread that updates the mesh
+	// Returns whether it published into an empty slot, the mesh then has to be announced to whoever takes it
+	bool publish() {
+		if (!this->unpublished) return false;
+		this->unpublished = false;
+
+		ChunkMeshData* data = new ChunkMeshData{ .vertices = std::move(this->vertices), .version = this->builtVersion };
+		this->vertices = {};
+
+		ChunkMeshData* replaced = this->pending.exchange(data);
+		delete replaced;
+
+		return replaced == nullptr;
+	}
+	// The published geometry if there is any, on any one thread (to be uploaded)
+	bool take(ChunkMeshData& data) {
+		ChunkMeshData* published = this->pending.exchange(nullptr);
+		if (published == nullptr) return false;
+
+		data = std::move(*published);
+		delete published;
+
+		return true;
+	}
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+#include "../world/chunk.h"
+
+// Same layout as the commands glMultiDrawElementsIndirect reads
+struct DrawElementsIndirectCommand {
+	uint32_t count = 0, instanceCount = 0, firstIndex = 0;
+	int32_t baseVertex = 0;
+	uint32_t baseInstance = 0;
+};
+
+// A chunk mesh as it sits in the terrain vertex buffer: indexCount indices of the shared quad index buffer, starting at vertex baseVertex
+struct ChunkDraw {
+	uint32_t indexCount = 0, baseVertex = 0;
+	glm::ivec3 position = glm::ivec3();
+};
+
+// The terrain draws of one frame, built on the CPU and issued with one multi draw
+// Command i draws one instance with baseInstance i, which selects origins[i] (the chunk origin relative to the eye) from an instanced attribute
+class DrawCommandList {
+private:
+	std::vector<DrawElementsIndirectCommand> commands;
+	std::vector<glm::vec3> origins;
+public:
+	void clear() {
+		this->commands.clear();
+		this->origins.clear();
+	}
+	// Empty chunks get no command
+	// Origins are subtracted in double so they stay precise however far the eye is from the world origin
+	void add(const ChunkDraw& draw, const glm::dvec3& eyePosition) {
+		if (draw.indexCount == 0) return;
+
+		this->commands.push_back({
+			.count = draw.indexCount,
+			.instanceCount = 1,
+			.firstIndex = 0,
+			.baseVertex = static_cast<int32_t>(draw.baseVertex),
+			.baseInstance = static_cast<uint32_t>(this->commands.size())
+		});
+		this->origins.push_back(glm::vec3(glm::dvec3(glm::i64vec3(draw.position) * glm::i64vec3(Chunk::WIDTH, Chunk::HEIGHT, Chunk::LENGTH)) - eyePosition));
+	}
+
+	const std::vector<DrawElementsIndirectCommand>& getCommands() const {
+		return this->commands;
+	}
+	const std::vector<glm::vec3>& getOrigins() const {
+		return this->origins;
+	}
+	size_t size() const {
+		return this->commands.size();
+	}
+};
+
+// Ids of the chunks that have anything to draw, kept compact so a frame walks only those instead of the whole world
+// Empty chunks (all air, or buried so deep no face is visible) are never in it
+// set() is O(1), removing an id moves the last one into its place
+class DrawableChunks {
+private:
+	static constexpr uint32_t NONE = UINT32_MAX;
+
+	std::vector<uint32_t> ids;
+	// Where each id is in ids, NONE while it is not drawable
+	std::vector<uint32_t> slots;
+public:
+	DrawableChunks(size_t count) : slots(count, DrawableChunks::NONE) {}
+
+	void set(uint32_t id, bool drawable) {
+		if (drawable == this->contains(id)) return;
+
+		if (drawable) {
+			this->slots[id] = static_cast<uint32_t>(this->ids.size());
+			this->ids.push_back(id);
+
+			return;
+		}
+
+		uint32_t last = this->ids.back();
+		this->ids[this->slots[id]] = last;
+		this->slots[last] = this->slots[id];
+
+		this->ids.pop_back();
+		this->slots[id] = DrawableChunks::NONE;
+	}
+	bool contains(uint32_t id) const {
+		return this->slots[id] != DrawableChunks::NONE;
+	}
+
+	const std::vector<uint32_t>& getIds() const {
+		return this->ids;
+	}
+	size_t size() const {
+		return this->ids.size();
+	}
+};
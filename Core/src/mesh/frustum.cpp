@@ -0,0 +1,91 @@
+#include "frustum.h"
+
+#include <algorithm>
+
+Frustum Frustum::fromMatrix(const glm::mat4& matrix) {
+	// glm is column major, matrix[c][r]
+	glm::vec4 rows[4];
+	for (int row = 0; row < 4; row++) {
+		rows[row] = glm::vec4(matrix[0][row], matrix[1][row], matrix[2][row], matrix[3][row]);
+	}
+
+	// Left, right, bottom, top, near, far
+	Frustum frustum;
+	frustum.planes[0] = rows[3] + rows[0];
+	frustum.planes[1] = rows[3] - rows[0];
+	frustum.planes[2] = rows[3] + rows[1];
+	frustum.planes[3] = rows[3] - rows[1];
+	frustum.planes[4] = rows[3] + rows[2];
+	frustum.planes[5] = rows[3] - rows[2];
+
+	for (glm::vec4& plane : frustum.planes) {
+		plane /= glm::length(glm::vec3(plane));
+	}
+
+	return frustum;
+}
+
+Frustum::Result Frustum::classify(const glm::vec3& min, const glm::vec3& max) const {
+	Result result = Inside;
+
+	for (const glm::vec4& plane : this->planes) {
+		glm::vec3 normal = glm::vec3(plane);
+
+		// The corners furthest along and against the plane normal
+		glm::vec3 positive = glm::vec3(normal.x >= 0.0f ? max.x : min.x, normal.y >= 0.0f ? max.y : min.y, normal.z >= 0.0f ? max.z : min.z);
+		glm::vec3 negative = glm::vec3(normal.x >= 0.0f ? min.x : max.x, normal.y >= 0.0f ? min.y : max.y, normal.z >= 0.0f ? min.z : max.z);
+
+		if (glm::dot(normal, positive) + plane.w < 0.0f) return Outside;
+		if (glm::dot(normal, negative) + plane.w < 0.0f) result = Intersecting;
+	}
+
+	return result;
+}
+
+size_t ChunkCulling::cull(const Frustum& frustum, const glm::dvec3& eyePosition, const glm::ivec3& chunks, std::vector<uint8_t>& visible) {
+	const glm::dvec3 chunkSize = glm::dvec3(Chunk::WIDTH, Chunk::HEIGHT, Chunk::LENGTH);
+	visible.assign(static_cast<size_t>(chunks.x) * chunks.y * chunks.z, 0);
+
+	// Box of the chunks from first to last (exclusive) relative to the eye, subtracted in double like the chunk origins
+	auto classify = [&](const glm::ivec3& first, const glm::ivec3& last) {
+		return frustum.classify(glm::vec3(glm::dvec3(first) * chunkSize - eyePosition), glm::vec3(glm::dvec3(last) * chunkSize - eyePosition));
+	};
+	auto setColumn = [&](int x, int z, uint8_t value) {
+		for (int y = 0; y < chunks.y; y++) {
+			visible[INDEX_FROM_XYZ(x, y, z, chunks.x, chunks.z)] = value;
+		}
+	};
+
+	size_t shown = 0;
+
+	for (int regionX = 0; regionX < chunks.x; regionX += ChunkCulling::REGION_SIZE) {
+		for (int regionZ = 0; regionZ < chunks.z; regionZ += ChunkCulling::REGION_SIZE) {
+			glm::ivec3 regionEnd = glm::ivec3(std::min(regionX + ChunkCulling::REGION_SIZE, chunks.x), chunks.y, std::min(regionZ + ChunkCulling::REGION_SIZE, chunks.z));
+			Frustum::Result region = classify(glm::ivec3(regionX, 0, regionZ), regionEnd);
+			if (region == Frustum::Outside) continue;
+
+			for (int x = regionX; x < regionEnd.x; x++) {
+				for (int z = regionZ; z < regionEnd.z; z++) {
+					Frustum::Result column = region == Frustum::Inside ? Frustum::Inside : classify(glm::ivec3(x, 0, z), glm::ivec3(x + 1, chunks.y, z + 1));
+
+					if (column == Frustum::Outside) continue;
+					if (column == Frustum::Inside) {
+						setColumn(x, z, 1);
+						shown += chunks.y;
+
+						continue;
+					}
+
+					for (int y = 0; y < chunks.y; y++) {
+						if (classify(glm::ivec3(x, y, z), glm::ivec3(x + 1, y + 1, z + 1)) == Frustum::Outside) continue;
+
+						visible[INDEX_FROM_XYZ(x, y, z, chunks.x, chunks.z)] = 1;
+						shown++;
+					}
+				}
+			}
+		}
+	}
+
+	return visible.size() - shown;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+#include "../world/chunk.h"
+
+// The six planes of a view frustum, a point p is inside a plane when dot(plane.xyz, p) + plane.w >= 0
+struct Frustum {
+	enum Result { Outside, Intersecting, Inside };
+
+	glm::vec4 planes[6] = {};
+
+	// Planes of a projection * view matrix (Gribb / Hartmann), in the space the matrix transforms from
+	static Frustum fromMatrix(const glm::mat4& matrix);
+
+	// Boxes that cross a corner of the frustum outside of it may still be reported as Intersecting, never the other way around
+	Result classify(const glm::vec3& min, const glm::vec3& max) const;
+};
+
+struct ChunkCulling {
+	// A region is REGION_SIZE x REGION_SIZE columns, a column all chunks above each other
+	static const int REGION_SIZE = 4;
+
+	// Sets visible[INDEX_FROM_XYZ(x, y, z, chunks.x, chunks.z)] to 1 for every chunk of a chunks.x x chunks.y x chunks.z world that intersects frustum, else 0
+	// frustum has to be relative to eyePosition (made from a matrix without the eye translation), like the chunk origins the terrain is drawn at
+	// Regions and columns entirely outside or inside are decided at once, only the chunks of columns crossing a plane are tested one by one
+	// Returns how many chunks were culled
+	static size_t cull(const Frustum& frustum, const glm::dvec3& eyePosition, const glm::ivec3& chunks, std::vector<uint8_t>& visible);
+};
@@ -0,0 +1,91 @@
+#include "uploadscheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+void UploadScheduler::add(uint32_t id, const glm::ivec3& position, ChunkMeshData&& data) {
+	if (this->slots[id] != UploadScheduler::NONE) {
+		this->pending[this->slots[id]].data = std::move(data);
+
+		return;
+	}
+
+	this->slots[id] = static_cast<uint32_t>(this->pending.size());
+	this->pending.push_back({ .id = id, .position = position, .data = std::move(data) });
+}
+
+UploadScheduler::Stats UploadScheduler::upload(const glm::dvec3& viewPosition, const Uploader& uploader) {
+	Stats stats;
+	if (this->pending.empty()) return stats;
+
+	// Ordered again every frame, the view may have moved since the meshes were added
+	const glm::dvec3 chunkSize = glm::dvec3(Chunk::WIDTH, Chunk::HEIGHT, Chunk::LENGTH);
+	this->order.clear();
+	for (uint32_t i = 0; i < this->pending.size(); i++) {
+		glm::dvec3 center = (glm::dvec3(this->pending[i].position) + 0.5) * chunkSize;
+		this->order.push_back({ glm::length(center - viewPosition), i });
+	}
+	std::sort(this->order.begin(), this->order.end());
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// Strictly nearest first, the first mesh that does not fit waits for the next frame along with everything behind it
+	size_t uploaded = 0;
+	for (; uploaded < this->order.size(); uploaded++) {
+		const Pending& mesh = this->pending[this->order[uploaded].second];
+		size_t bytes = mesh.data.getVertexCount() * sizeof(uint32_t);
+
+		if (uploaded > 0) {
+			if (this->byteBudget > 0 && stats.bytes + bytes > this->byteBudget) break;
+			if (this->timeBudget > 0.0 && stats.milliseconds >= this->timeBudget) break;
+		}
+
+		uploader(mesh.id, mesh.data);
+
+		stats.meshes++;
+		stats.bytes += bytes;
+		stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// Uploaded meshes are removed by moving the last pending one into their place, highest indices first so none is moved twice
+	std::sort(this->order.begin(), this->order.begin() + uploaded, [](const std::pair<double, uint32_t>& a, const std::pair<double, uint32_t>& b) {
+		return a.second > b.second;
+	});
+	for (size_t i = 0; i < uploaded; i++) {
+		uint32_t index = this->order[i].second;
+		this->slots[this->pending[index].id] = UploadScheduler::NONE;
+
+		if (index != this->pending.size() - 1) {
+			this->pending[index] = std::move(this->pending.back());
+			this->slots[this->pending[index].id] = index;
+		}
+		this->pending.pop_back();
+	}
+
+	return stats;
+}
+
+void FrameHistogram::add(double milliseconds) {
+	size_t bucket = 0;
+	while (bucket < FrameHistogram::BUCKETS - 1 && milliseconds > FrameHistogram::LIMITS[bucket]) bucket++;
+
+	this->counts[bucket]++;
+	this->frames++;
+	this->max = std::max(this->max, milliseconds);
+}
+
+std::string FrameHistogram::toString() const {
+	std::string text;
+	char buffer[32];
+
+	for (size_t bucket = 0; bucket < FrameHistogram::BUCKETS; bucket++) {
+		if (bucket < FrameHistogram::BUCKETS - 1) snprintf(buffer, sizeof(buffer), "<=%gms: %zu, ", FrameHistogram::LIMITS[bucket], this->counts[bucket]);
+		else snprintf(buffer, sizeof(buffer), ">%gms: %zu, ", FrameHistogram::LIMITS[bucket - 1], this->counts[bucket]);
+
+		text += buffer;
+	}
+
+	snprintf(buffer, sizeof(buffer), "max %.1fms", this->max);
+	return text + buffer;
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <functional>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "chunkmesh.h"
+
+// Meshes waiting to be uploaded, handed out a few per frame so a big edit or the initial load never uploads everything in one frame
+// Each frame uploads the pending meshes nearest to the view until the byte or the time budget is used up, at least one mesh always goes
+// Only the order and the budget are decided here, the upload itself is left to the uploader passed to upload()
+class UploadScheduler {
+public:
+	// Called with the chunk id and its mesh, in the order the meshes should show up
+	using Uploader = std::function<void(uint32_t id, const ChunkMeshData& data)>;
+
+	// What the last upload() did
+	struct Stats {
+		size_t meshes = 0, bytes = 0;
+		double milliseconds = 0.0;
+	};
+private:
+	static constexpr uint32_t NONE = UINT32_MAX;
+
+	struct Pending {
+		uint32_t id;
+		glm::ivec3 position;
+		ChunkMeshData data;
+	};
+	std::vector<Pending> pending;
+	// Where each id is in pending, NONE while it has nothing to upload
+	std::vector<uint32_t> slots;
+
+	// 0 leaves that budget out
+	size_t byteBudget;
+	double timeBudget;
+
+	// Distance from the view, nearest first, and index into pending
+	std::vector<std::pair<double, uint32_t>> order;
+public:
+	// count is the number of chunk ids, byteBudget in bytes of vertices and timeBudget in milliseconds per frame
+	UploadScheduler(size_t count, size_t byteBudget = 4 << 20, double timeBudget = 4.0) : slots(count, UploadScheduler::NONE), byteBudget(byteBudget), timeBudget(timeBudget) {}
+
+	// Queues the mesh of chunk id at position (in chunks), a mesh still waiting for the same id is replaced, it would be stale anyway
+	void add(uint32_t id, const glm::ivec3& position, ChunkMeshData&& data);
+	// Uploads the pending meshes nearest to viewPosition (in blocks) that fit into the budget of one frame
+	Stats upload(const glm::dvec3& viewPosition, const Uploader& uploader);
+
+	void setByteBudget(size_t bytes) {
+		this->byteBudget = bytes;
+	}
+	void setTimeBudget(double milliseconds) {
+		this->timeBudget = milliseconds;
+	}
+	size_t getByteBudget() const {
+		return this->byteBudget;
+	}
+	double getTimeBudget() const {
+		return this->timeBudget;
+	}
+	size_t getPendingCount() const {
+		return this->pending.size();
+	}
+};
+
+// Counts frames by how long they took, bucket i holds the frames up to LIMITS[i] milliseconds and the last bucket all slower ones
+class FrameHistogram {
+public:
+	static constexpr double LIMITS[] = { 4.0, 8.0, 16.7, 33.3, 50.0, 100.0 };
+	static constexpr size_t BUCKETS = sizeof(LIMITS) / sizeof(LIMITS[0]) + 1;
+private:
+	size_t counts[BUCKETS] = {};
+	size_t frames = 0;
+	double max = 0.0;
+public:
+	void add(double milliseconds);
+	void clear() {
+		*this = FrameHistogram();
+	}
+
+	size_t getCount(size_t bucket) const {
+		return this->counts[bucket];
+	}
+	size_t getFrames() const {
+		return this->frames;
+	}
+	double getMax() const {
+		return this->max;
+	}
+
+	// One line like "<=4ms: 12, <=8ms: 3, ... >100ms: 0, max 9.1ms"
+	std::string toString() const;
+};
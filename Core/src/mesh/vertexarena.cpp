@@ -0,0 +1,118 @@
+#include "vertexarena.h"
+
+#include <algorithm>
+
+static inline uint32_t getPages(uint32_t vertices) {
+	return (vertices + VertexArena::PAGE_SIZE - 1) / VertexArena::PAGE_SIZE;
+}
+
+VertexArena::VertexArena(uint32_t capacity) {
+	this->grow(capacity);
+}
+
+void VertexArena::release(uint32_t page, uint32_t pages) {
+	auto next = this->freeRanges.lower_bound(page);
+
+	if (next != this->freeRanges.begin()) {
+		auto previous = std::prev(next);
+
+		if (previous->first + previous->second == page) {
+			page = previous->first;
+			pages += previous->second;
+			this->freeRanges.erase(previous);
+		}
+	}
+	if (next != this->freeRanges.end() && page + pages == next->first) {
+		pages += next->second;
+		this->freeRanges.erase(next);
+	}
+
+	this->freeRanges[page] = pages;
+}
+
+uint32_t VertexArena::allocate(uint32_t vertices) {
+	uint32_t pages = getPages(vertices);
+
+	// Best fit keeps big ranges for big meshes
+	auto best = this->freeRanges.end();
+	for (auto range = this->freeRanges.begin(); range != this->freeRanges.end(); range++) {
+		if (range->second < pages || (best != this->freeRanges.end() && range->second >= best->second)) continue;
+
+		best = range;
+		if (range->second == pages) break;
+	}
+	if (best == this->freeRanges.end()) return VertexArena::INVALID;
+
+	Allocation allocation = { .page = best->first, .pages = pages, .vertices = vertices, .used = true };
+
+	if (best->second > pages) this->freeRanges[best->first + pages] = best->second - pages;
+	this->freeRanges.erase(best);
+	this->usedPages += pages;
+
+	if (this->freeIds.empty()) {
+		this->allocations.push_back(allocation);
+
+		return static_cast<uint32_t>(this->allocations.size() - 1);
+	}
+
+	uint32_t id = this->freeIds.back();
+	this->freeIds.pop_back();
+	this->allocations[id] = allocation;
+
+	return id;
+}
+
+void VertexArena::free(uint32_t id) {
+	if (id >= this->allocations.size() || !this->allocations[id].used) return;
+	Allocation& allocation = this->allocations[id];
+
+	this->release(allocation.page, allocation.pages);
+	this->usedPages -= allocation.pages;
+
+	allocation.used = false;
+	this->freeIds.push_back(id);
+}
+
+uint32_t VertexArena::getLargestFree() const {
+	uint32_t pages = 0;
+	for (const auto& range : this->freeRanges) {
+		pages = std::max(pages, range.second);
+	}
+
+	return pages * VertexArena::PAGE_SIZE;
+}
+
+std::vector<VertexArena::Move> VertexArena::defragment() {
+	std::vector<uint32_t> order;
+	for (uint32_t id = 0; id < this->allocations.size(); id++) {
+		if (this->allocations[id].used) order.push_back(id);
+	}
+	std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) { return this->allocations[a].page < this->allocations[b].page; });
+
+	std::vector<Move> moves;
+	uint32_t page = 0;
+
+	for (uint32_t id : order) {
+		Allocation& allocation = this->allocations[id];
+
+		if (allocation.page != page) {
+			moves.push_back({ .from = allocation.page * VertexArena::PAGE_SIZE, .to = page * VertexArena::PAGE_SIZE, .size = allocation.vertices });
+			allocation.page = page;
+		}
+
+		page += allocation.pages;
+	}
+
+	this->freeRanges.clear();
+	if (page < this->pages) this->freeRanges[page] = this->pages - page;
+
+	return moves;
+}
+
+void VertexArena::grow(uint32_t capacity) {
+	uint32_t pages = getPages(capacity);
+	if (pages <= this->pages) return;
+
+	this->release(this->pages, pages - this->pages);
+	this->pages = pages;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <cstddef>
+
+// Hands out vertex ranges of one big vertex buffer, every chunk mesh lives in one range
+// Only the bookkeeping happens here, the owner of the buffer uploads and copies the data, so this works (and can be tested) without a GPU
+// Space is counted in pages of PAGE_SIZE vertices and given out best fit from a list of free ranges, neighboring free ranges are merged
+class VertexArena {
+public:
+	static const uint32_t PAGE_SIZE = 256;
+	static const uint32_t INVALID = UINT32_MAX;
+
+	// Where defragment() moved the vertices of an allocation, in vertices
+	struct Move {
+		uint32_t from = 0, to = 0, size = 0;
+	};
+private:
+	struct Allocation {
+		uint32_t page = 0, pages = 0, vertices = 0;
+		bool used = false;
+	};
+
+	// Indexed by allocation id, ids of freed allocations are reused
+	std::vector<Allocation> allocations;
+	std::vector<uint32_t> freeIds;
+
+	// First page -> page count of every free range
+	std::map<uint32_t, uint32_t> freeRanges;
+	uint32_t pages = 0, usedPages = 0;
+
+	// Returns pages to the free list, merged with the free ranges right before and after them
+	void release(uint32_t page, uint32_t pages);
+public:
+	// capacity in vertices, rounded up to whole pages
+	VertexArena(uint32_t capacity = 0);
+
+	// Returns the id of a new range of at least vertices (more than 0) vertices, INVALID when no free range is big enough
+	// A failed allocation may still fit after defragment() when getFree() is large enough, otherwise the arena has to grow()
+	uint32_t allocate(uint32_t vertices);
+	void free(uint32_t id);
+
+	// First vertex of the allocation, changes when defragment() moves it
+	uint32_t getOffset(uint32_t id) const {
+		return this->allocations[id].page * VertexArena::PAGE_SIZE;
+	}
+	// The vertex count it was allocated with
+	uint32_t getSize(uint32_t id) const {
+		return this->allocations[id].vertices;
+	}
+
+	uint32_t getCapacity() const {
+		return this->pages * VertexArena::PAGE_SIZE;
+	}
+	uint32_t getFree() const {
+		return (this->pages - this->usedPages) * VertexArena::PAGE_SIZE;
+	}
+	// The biggest allocation that fits without defragment(), in vertices
+	uint32_t getLargestFree() const;
+	size_t getFreeRangeCount() const {
+		return this->freeRanges.size();
+	}
+
+	// Packs every allocation to the front in offset order, so all free space is one range at the end
+	// Returns a move for every allocation that changed place, the others stay where they are
+	// A move may overlap the source of a later one, so copy the old contents into a new buffer and apply the moves on top, reading from the old one
+	std::vector<Move> defragment();
+	// Adds free pages at the end, allocations stay where they are
+	void grow(uint32_t capacity);
+};
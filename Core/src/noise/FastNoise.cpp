@@ -31,6 +31,8 @@
 #include <math.h>
 #include <assert.h>
 
+#include <string.h>
+
 #include <algorithm>
 #include <random>
 
@@ -2357,3 +2359,284 @@ void FastNoise::SingleGradientPerturb(unsigned char offset, FN_DECIMAL warpAmp,
 	x += Lerp(lx0x, lx1x, ys) * warpAmp;
 	y += Lerp(ly0x, ly1x, ys) * warpAmp;
 }
+
+// Batched Grid Sampling
+#if !defined(FN_USE_DOUBLES) && (defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__))
+#define FN_GRID_SIMD
+
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+struct GridLattice
+{
+	const unsigned char* perm;
+	const unsigned char* perm12;
+	int seed;
+	FN_DECIMAL frequency;
+	int interp;
+};
+
+static int WhiteNoiseBits(FN_DECIMAL f)
+{
+	int bits;
+	memcpy(&bits, &f, sizeof(bits));
+	return bits ^ (bits >> 16);
+}
+
+#ifdef FN_GRID_SIMD
+struct SSE2Ops
+{
+	typedef __m128 Float;
+	typedef __m128i Int;
+	static const int LANES = 4;
+
+	static Float Set1(float f) { return _mm_set1_ps(f); }
+	static Int Set1(int i) { return _mm_set1_epi32(i); }
+	static Int LaneIndices() { return _mm_setr_epi32(0, 1, 2, 3); }
+
+	static Float Load(const float* p) { return _mm_loadu_ps(p); }
+	static void Store(float* p, Float a) { _mm_storeu_ps(p, a); }
+	static void Store(int* p, Int a) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), a); }
+
+	static Float Add(Float a, Float b) { return _mm_add_ps(a, b); }
+	static Float Sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+	static Float Mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+	static Float Div(Float a, Float b) { return _mm_div_ps(a, b); }
+	static Float And(Float a, Float b) { return _mm_and_ps(a, b); }
+	static Float Less(Float a, Float b) { return _mm_cmplt_ps(a, b); }
+	static Float GreaterEqual(Float a, Float b) { return _mm_cmpge_ps(a, b); }
+
+	static Int Add(Int a, Int b) { return _mm_add_epi32(a, b); }
+	static Int And(Int a, Int b) { return _mm_and_si128(a, b); }
+	static Int AndNot(Int a, Int b) { return _mm_andnot_si128(a, b); }
+	static Int Or(Int a, Int b) { return _mm_or_si128(a, b); }
+	static Int Xor(Int a, Int b) { return _mm_xor_si128(a, b); }
+	static Int ShiftRightArithmetic16(Int a) { return _mm_srai_epi32(a, 16); }
+
+	// SSE2 has no 32 bit mullo, multiply even and odd lanes separately and keep the low halves
+	static Int Mul(Int a, Int b)
+	{
+		Int even = _mm_mul_epu32(a, b);
+		Int odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+		return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+	}
+
+	static Int Truncate(Float a) { return _mm_cvttps_epi32(a); }
+	static Float ConvertToFloat(Int a) { return _mm_cvtepi32_ps(a); }
+	static Int CastToInt(Float a) { return _mm_castps_si128(a); }
+	static Float CastToFloat(Int a) { return _mm_castsi128_ps(a); }
+};
+
+namespace FastNoiseGridSSE2
+{
+	typedef SSE2Ops V;
+#include "FastNoiseGrid.inl"
+}
+
+// The AVX2 kernels are compiled for AVX2 only (no FMA, which would change rounding) and are only called after the runtime check
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+struct AVX2Ops
+{
+	typedef __m256 Float;
+	typedef __m256i Int;
+	static const int LANES = 8;
+
+	static Float Set1(float f) { return _mm256_set1_ps(f); }
+	static Int Set1(int i) { return _mm256_set1_epi32(i); }
+	static Int LaneIndices() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+
+	static Float Load(const float* p) { return _mm256_loadu_ps(p); }
+	static void Store(float* p, Float a) { _mm256_storeu_ps(p, a); }
+	static void Store(int* p, Int a) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), a); }
+
+	static Float Add(Float a, Float b) { return _mm256_add_ps(a, b); }
+	static Float Sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+	static Float Mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+	static Float Div(Float a, Float b) { return _mm256_div_ps(a, b); }
+	static Float And(Float a, Float b) { return _mm256_and_ps(a, b); }
+	static Float Less(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	static Float GreaterEqual(Float a, Float b) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+
+	static Int Add(Int a, Int b) { return _mm256_add_epi32(a, b); }
+	static Int And(Int a, Int b) { return _mm256_and_si256(a, b); }
+	static Int AndNot(Int a, Int b) { return _mm256_andnot_si256(a, b); }
+	static Int Or(Int a, Int b) { return _mm256_or_si256(a, b); }
+	static Int Xor(Int a, Int b) { return _mm256_xor_si256(a, b); }
+	static Int ShiftRightArithmetic16(Int a) { return _mm256_srai_epi32(a, 16); }
+	static Int Mul(Int a, Int b) { return _mm256_mullo_epi32(a, b); }
+
+	static Int Truncate(Float a) { return _mm256_cvttps_epi32(a); }
+	static Float ConvertToFloat(Int a) { return _mm256_cvtepi32_ps(a); }
+	static Int CastToInt(Float a) { return _mm256_castps_si256(a); }
+	static Float CastToFloat(Int a) { return _mm256_castsi256_ps(a); }
+};
+
+namespace FastNoiseGridAVX2
+{
+	typedef AVX2Ops V;
+#include "FastNoiseGrid.inl"
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+static FastNoise::GridSIMD DetectGridSIMD()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return FastNoise::GridSSE2;
+
+	__cpuid(info, 1);
+	bool osAVX = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+
+	__cpuidex(info, 7, 0);
+	return osAVX && (info[1] & (1 << 5)) ? FastNoise::GridAVX2 : FastNoise::GridSSE2;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") ? FastNoise::GridAVX2 : FastNoise::GridSSE2;
+#endif
+}
+#endif
+
+void FastNoise::SetGridSIMD(GridSIMD gridSIMD)
+{
+#ifdef FN_GRID_SIMD
+	static const GridSIMD supported = DetectGridSIMD();
+	m_gridSIMD = std::min(gridSIMD, supported);
+#else
+	m_gridSIMD = GridScalar;
+#endif
+}
+
+void FastNoise::FillPerlinGrid(FN_DECIMAL* out, FN_DECIMAL originX, FN_DECIMAL originY, FN_DECIMAL stepX, FN_DECIMAL stepY, int countX, int countY) const
+{
+	GridLattice lattice = { m_perm, m_perm12, m_seed, m_frequency, m_interp };
+
+	for (int iy = 0; iy < countY; iy++)
+	{
+		FN_DECIMAL y = originY + FN_DECIMAL(iy) * stepY;
+		FN_DECIMAL* row = out + iy * countX;
+
+		switch (m_gridSIMD)
+		{
+#ifdef FN_GRID_SIMD
+		case GridAVX2:
+			FastNoiseGridAVX2::PerlinRow(lattice, row, originX, stepX, countX, y);
+			break;
+		case GridSSE2:
+			FastNoiseGridSSE2::PerlinRow(lattice, row, originX, stepX, countX, y);
+			break;
+#endif
+		default:
+			for (int ix = 0; ix < countX; ix++)
+				row[ix] = GetPerlin(originX + FN_DECIMAL(ix) * stepX, y);
+			break;
+		}
+	}
+}
+
+void FastNoise::FillSimplexGrid(FN_DECIMAL* out, FN_DECIMAL originX, FN_DECIMAL originY, FN_DECIMAL originZ, FN_DECIMAL stepX, FN_DECIMAL stepY, FN_DECIMAL stepZ, int countX, int countY, int countZ) const
+{
+	GridLattice lattice = { m_perm, m_perm12, m_seed, m_frequency, m_interp };
+
+	for (int iz = 0; iz < countZ; iz++)
+	{
+		FN_DECIMAL z = originZ + FN_DECIMAL(iz) * stepZ;
+
+		for (int iy = 0; iy < countY; iy++)
+		{
+			FN_DECIMAL y = originY + FN_DECIMAL(iy) * stepY;
+			FN_DECIMAL* row = out + (iy + iz * countY) * countX;
+
+			switch (m_gridSIMD)
+			{
+#ifdef FN_GRID_SIMD
+			case GridAVX2:
+				FastNoiseGridAVX2::SimplexRow(lattice, row, originX, stepX, countX, y, z);
+				break;
+			case GridSSE2:
+				FastNoiseGridSSE2::SimplexRow(lattice, row, originX, stepX, countX, y, z);
+				break;
+#endif
+			default:
+				for (int ix = 0; ix < countX; ix++)
+					row[ix] = GetSimplex(originX + FN_DECIMAL(ix) * stepX, y, z);
+				break;
+			}
+		}
+	}
+}
+
+void FastNoise::FillWhiteNoiseGrid(FN_DECIMAL* out, FN_DECIMAL originX, FN_DECIMAL originY, FN_DECIMAL stepX, FN_DECIMAL stepY, int countX, int countY) const
+{
+	GridLattice lattice = { m_perm, m_perm12, m_seed, m_frequency, m_interp };
+
+	for (int iy = 0; iy < countY; iy++)
+	{
+		FN_DECIMAL y = originY + FN_DECIMAL(iy) * stepY;
+		FN_DECIMAL* row = out + iy * countX;
+
+		switch (m_gridSIMD)
+		{
+#ifdef FN_GRID_SIMD
+		case GridAVX2:
+			FastNoiseGridAVX2::WhiteNoiseRow(lattice, row, originX, stepX, countX, y);
+			break;
+		case GridSSE2:
+			FastNoiseGridSSE2::WhiteNoiseRow(lattice, row, originX, stepX, countX, y);
+			break;
+#endif
+		default:
+			for (int ix = 0; ix < countX; ix++)
+				row[ix] = GetWhiteNoise(originX + FN_DECIMAL(ix) * stepX, y);
+			break;
+		}
+	}
+}
+
+void FastNoise::FillWhiteNoiseGrid(FN_DECIMAL* out, FN_DECIMAL originX, FN_DECIMAL originY, FN_DECIMAL originZ, FN_DECIMAL stepX, FN_DECIMAL stepY, FN_DECIMAL stepZ, int countX, int countY, int countZ) const
+{
+	GridLattice lattice = { m_perm, m_perm12, m_seed, m_frequency, m_interp };
+
+	for (int iz = 0; iz < countZ; iz++)
+	{
+		FN_DECIMAL z = originZ + FN_DECIMAL(iz) * stepZ;
+
+		for (int iy = 0; iy < countY; iy++)
+		{
+			FN_DECIMAL y = originY + FN_DECIMAL(iy) * stepY;
+			FN_DECIMAL* row = out + (iy + iz * countY) * countX;
+
+			switch (m_gridSIMD)
+			{
+#ifdef FN_GRID_SIMD
+			case GridAVX2:
+				FastNoiseGridAVX2::WhiteNoiseRow(lattice, row, originX, stepX, countX, y, z);
+				break;
+			case GridSSE2:
+				FastNoiseGridSSE2::WhiteNoiseRow(lattice, row, originX, stepX, countX, y, z);
+				break;
+#endif
+			default:
+				for (int ix = 0; ix < countX; ix++)
+					row[ix] = GetWhiteNoise(originX + FN_DECIMAL(ix) * stepX, y, z);
+				break;
+			}
+		}
+	}
+}
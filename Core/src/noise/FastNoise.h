@@ -45,13 +45,14 @@ typedef float FN_DECIMAL;
 class FastNoise
 {
 public:
-	explicit FastNoise(int seed = 1337) { SetSeed(seed); CalculateFractalBounding(); }
+	explicit FastNoise(int seed = 1337) { SetSeed(seed); CalculateFractalBounding(); SetGridSIMD(GridAVX2); }
 
 	enum NoiseType { Value, ValueFractal, Perlin, PerlinFractal, Simplex, SimplexFractal, Cellular, WhiteNoise, Cubic, CubicFractal };
 	enum Interp { Linear, Hermite, Quintic };
 	enum FractalType { FBM, Billow, RigidMulti };
 	enum CellularDistanceFunction { Euclidean, Manhattan, Natural };
 	enum CellularReturnType { CellValue, NoiseLookup, Distance, Distance2, Distance2Add, Distance2Sub, Distance2Mul, Distance2Div };
+	enum GridSIMD { GridScalar, GridSSE2, GridAVX2 };
 
 	// Sets seed used for all noise types
 	// Default: 1337
@@ -161,6 +162,24 @@ public:
 	// Returns the maximum warp distance from original location when using GradientPerturb{Fractal}(...)
 	FN_DECIMAL GetGradientPerturbAmp() const { return m_gradientPerturbAmp; }
 
+	// Sets the instruction set used by the Fill*Grid(...) functions
+	// Requests above what the CPU supports are lowered to the best supported level
+	// Default: best supported (AVX2, SSE2 or Scalar)
+	void SetGridSIMD(GridSIMD gridSIMD);
+
+	// Returns the instruction set used by the Fill*Grid(...) functions
+	GridSIMD GetGridSIMD() const { return m_gridSIMD; }
+
+	// Fills a strided grid of samples, x varying fastest, then y, then z:
+	// out[ix + iy * countX + iz * countX * countY] = Get*(originX + ix * stepX, originY + iy * stepY, originZ + iz * stepZ)
+	// The sample coordinate is computed in FN_DECIMAL as origin + FN_DECIMAL(i) * step, and the SIMD kernels perform
+	// the same IEEE operations in the same order as the scalar functions, so results are bit-identical to calling
+	// Get*(...) at that coordinate as long as the compiler does not contract or reorder float math (no /fp:fast, -ffast-math or FMA)
+	void FillPerlinGrid(FN_DECIMAL* out, FN_DECIMAL originX, FN_DECIMAL originY, FN_DECIMAL stepX, FN_DECIMAL stepY, int countX, int countY) const;
+	void FillSimplexGrid(FN_DECIMAL* out, FN_DECIMAL originX, FN_DECIMAL originY, FN_DECIMAL originZ, FN_DECIMAL stepX, FN_DECIMAL stepY, FN_DECIMAL stepZ, int countX, int countY, int countZ) const;
+	void FillWhiteNoiseGrid(FN_DECIMAL* out, FN_DECIMAL originX, FN_DECIMAL originY, FN_DECIMAL stepX, FN_DECIMAL stepY, int countX, int countY) const;
+	void FillWhiteNoiseGrid(FN_DECIMAL* out, FN_DECIMAL originX, FN_DECIMAL originY, FN_DECIMAL originZ, FN_DECIMAL stepX, FN_DECIMAL stepY, FN_DECIMAL stepZ, int countX, int countY, int countZ) const;
+
 	//2D
 	FN_DECIMAL GetValue(FN_DECIMAL x, FN_DECIMAL y) const;
 	FN_DECIMAL GetValueFractal(FN_DECIMAL x, FN_DECIMAL y) const;
@@ -240,6 +259,8 @@ private:
 
 	FN_DECIMAL m_gradientPerturbAmp = FN_DECIMAL(1);
 
+	GridSIMD m_gridSIMD = GridScalar;
+
 	void CalculateFractalBounding();
 
 	//2D
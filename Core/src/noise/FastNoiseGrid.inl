@@ -0,0 +1,234 @@
+// FastNoiseGrid.inl
+//
+// Row kernels for FastNoise::Fill*Grid(...)
+// Included by FastNoise.cpp once per instruction set, inside a namespace that defines
+// V (the vector ops: SSE2Ops or AVX2Ops) so the same source is compiled for every target.
+// Every kernel evaluates LANES consecutive x samples at once and mirrors the scalar
+// FastNoise code operation for operation so that results stay bit-identical.
+
+typedef V::Float Float;
+typedef V::Int Int;
+
+static inline Float SampleX(FN_DECIMAL originX, FN_DECIMAL stepX, int ix)
+{
+	Float lane = V::ConvertToFloat(V::Add(V::Set1(ix), V::LaneIndices()));
+	return V::Add(V::Set1(originX), V::Mul(lane, V::Set1(stepX)));
+}
+
+static inline Int FastFloorV(Float f)
+{
+	// (f >= 0 ? (int)f : (int)f - 1), the mask is -1 where f < 0
+	return V::Add(V::Truncate(f), V::CastToInt(V::Less(f, V::Set1(FN_DECIMAL(0)))));
+}
+
+static inline Float InterpV(int interp, Float t)
+{
+	switch (interp)
+	{
+	case FastNoise::Hermite:
+		return V::Mul(V::Mul(t, t), V::Sub(V::Set1(FN_DECIMAL(3)), V::Mul(V::Set1(FN_DECIMAL(2)), t)));
+	case FastNoise::Quintic:
+		return V::Mul(V::Mul(V::Mul(t, t), t), V::Add(V::Mul(t, V::Sub(V::Mul(t, V::Set1(FN_DECIMAL(6))), V::Set1(FN_DECIMAL(15)))), V::Set1(FN_DECIMAL(10))));
+	default:
+		return t;
+	}
+}
+
+static inline Float LerpV(Float a, Float b, Float t)
+{
+	return V::Add(a, V::Mul(t, V::Sub(b, a)));
+}
+
+static inline Float Select(Int mask, Float a)
+{
+	return V::And(V::CastToFloat(mask), a);
+}
+
+static inline void StoreRow(FN_DECIMAL* out, Float value, int count)
+{
+	if (count >= V::LANES)
+	{
+		V::Store(out, value);
+		return;
+	}
+
+	alignas(32) FN_DECIMAL lanes[V::LANES];
+	V::Store(lanes, value);
+
+	for (int i = 0; i < count; i++)
+		out[i] = lanes[i];
+}
+
+static inline void GradLookup2D(const GridLattice& lattice, Int x, int y, Float& gradX, Float& gradY)
+{
+	alignas(32) int xs[V::LANES];
+	alignas(32) FN_DECIMAL gx[V::LANES], gy[V::LANES];
+	V::Store(xs, x);
+
+	unsigned char row = lattice.perm[y & 0xff];
+	for (int i = 0; i < V::LANES; i++)
+	{
+		unsigned char lutPos = lattice.perm12[(xs[i] & 0xff) + row];
+		gx[i] = GRAD_X[lutPos];
+		gy[i] = GRAD_Y[lutPos];
+	}
+
+	gradX = V::Load(gx);
+	gradY = V::Load(gy);
+}
+
+static inline Float GradCoord3DV(const GridLattice& lattice, Int x, Int y, Int z, Float xd, Float yd, Float zd)
+{
+	alignas(32) int xs[V::LANES], ys[V::LANES], zs[V::LANES];
+	alignas(32) FN_DECIMAL gx[V::LANES], gy[V::LANES], gz[V::LANES];
+	V::Store(xs, x);
+	V::Store(ys, y);
+	V::Store(zs, z);
+
+	for (int i = 0; i < V::LANES; i++)
+	{
+		unsigned char lutPos = lattice.perm12[(xs[i] & 0xff) + lattice.perm[(ys[i] & 0xff) + lattice.perm[zs[i] & 0xff]]];
+		gx[i] = GRAD_X[lutPos];
+		gy[i] = GRAD_Y[lutPos];
+		gz[i] = GRAD_Z[lutPos];
+	}
+
+	return V::Add(V::Add(V::Mul(xd, V::Load(gx)), V::Mul(yd, V::Load(gy))), V::Mul(zd, V::Load(gz)));
+}
+
+static void PerlinRow(const GridLattice& lattice, FN_DECIMAL* out, FN_DECIMAL originX, FN_DECIMAL stepX, int count, FN_DECIMAL y)
+{
+	// y is shared by the whole row, so its part of SinglePerlin(...) is evaluated once in scalar
+	y *= lattice.frequency;
+
+	int y0 = FastFloor(y);
+	int y1 = y0 + 1;
+
+	FN_DECIMAL yd0 = y - (FN_DECIMAL)y0;
+	FN_DECIMAL yd1 = yd0 - 1;
+	FN_DECIMAL ys = lattice.interp == FastNoise::Hermite ? InterpHermiteFunc(yd0) : lattice.interp == FastNoise::Quintic ? InterpQuinticFunc(yd0) : yd0;
+
+	Float yd0V = V::Set1(yd0);
+	Float yd1V = V::Set1(yd1);
+	Float ysV = V::Set1(ys);
+	Int one = V::Set1(1);
+
+	for (int ix = 0; ix < count; ix += V::LANES)
+	{
+		Float x = V::Mul(SampleX(originX, stepX, ix), V::Set1(lattice.frequency));
+
+		Int x0 = FastFloorV(x);
+		Int x1 = V::Add(x0, one);
+
+		Float xd0 = V::Sub(x, V::ConvertToFloat(x0));
+		Float xd1 = V::Sub(xd0, V::Set1(FN_DECIMAL(1)));
+		Float xs = InterpV(lattice.interp, xd0);
+
+		Float gx00, gy00, gx10, gy10, gx01, gy01, gx11, gy11;
+		GradLookup2D(lattice, x0, y0, gx00, gy00);
+		GradLookup2D(lattice, x1, y0, gx10, gy10);
+		GradLookup2D(lattice, x0, y1, gx01, gy01);
+		GradLookup2D(lattice, x1, y1, gx11, gy11);
+
+		Float xf0 = LerpV(V::Add(V::Mul(xd0, gx00), V::Mul(yd0V, gy00)), V::Add(V::Mul(xd1, gx10), V::Mul(yd0V, gy10)), xs);
+		Float xf1 = LerpV(V::Add(V::Mul(xd0, gx01), V::Mul(yd1V, gy01)), V::Add(V::Mul(xd1, gx11), V::Mul(yd1V, gy11)), xs);
+
+		StoreRow(out + ix, LerpV(xf0, xf1, ysV), count - ix);
+	}
+}
+
+static inline Float SimplexCorner(const GridLattice& lattice, Int i, Int j, Int k, Float x, Float y, Float z)
+{
+	Float t = V::Sub(V::Sub(V::Sub(V::Set1(FN_DECIMAL(0.6)), V::Mul(x, x)), V::Mul(y, y)), V::Mul(z, z));
+	Int inside = V::CastToInt(V::GreaterEqual(t, V::Set1(FN_DECIMAL(0))));
+
+	t = V::Mul(t, t);
+	return Select(inside, V::Mul(V::Mul(t, t), GradCoord3DV(lattice, i, j, k, x, y, z)));
+}
+
+static void SimplexRow(const GridLattice& lattice, FN_DECIMAL* out, FN_DECIMAL originX, FN_DECIMAL stepX, int count, FN_DECIMAL y, FN_DECIMAL z)
+{
+	Float yV = V::Set1(y * lattice.frequency);
+	Float zV = V::Set1(z * lattice.frequency);
+	Int one = V::Set1(1);
+
+	for (int ix = 0; ix < count; ix += V::LANES)
+	{
+		Float x = V::Mul(SampleX(originX, stepX, ix), V::Set1(lattice.frequency));
+
+		Float t = V::Mul(V::Add(V::Add(x, yV), zV), V::Set1(F3));
+		Int i = FastFloorV(V::Add(x, t));
+		Int j = FastFloorV(V::Add(yV, t));
+		Int k = FastFloorV(V::Add(zV, t));
+
+		t = V::Mul(V::ConvertToFloat(V::Add(V::Add(i, j), k)), V::Set1(G3));
+		Float x0 = V::Sub(x, V::Sub(V::ConvertToFloat(i), t));
+		Float y0 = V::Sub(yV, V::Sub(V::ConvertToFloat(j), t));
+		Float z0 = V::Sub(zV, V::Sub(V::ConvertToFloat(k), t));
+
+		// Branch-free version of the simplex corner ordering in SingleSimplex(...)
+		Int a = V::CastToInt(V::GreaterEqual(x0, y0));
+		Int b = V::CastToInt(V::GreaterEqual(y0, z0));
+		Int c = V::CastToInt(V::GreaterEqual(x0, z0));
+
+		Int i1 = V::And(V::And(a, c), one);
+		Int j1 = V::And(V::AndNot(a, b), one);
+		Int k1 = V::AndNot(V::Or(b, V::And(a, c)), one);
+		Int i2 = V::And(V::Or(a, c), one);
+		Int j2 = V::AndNot(V::AndNot(b, a), one);
+		Int k2 = V::AndNot(V::And(b, c), one);
+
+		Float x1 = V::Add(V::Sub(x0, V::ConvertToFloat(i1)), V::Set1(G3));
+		Float y1 = V::Add(V::Sub(y0, V::ConvertToFloat(j1)), V::Set1(G3));
+		Float z1 = V::Add(V::Sub(z0, V::ConvertToFloat(k1)), V::Set1(G3));
+		Float x2 = V::Add(V::Sub(x0, V::ConvertToFloat(i2)), V::Set1(2 * G3));
+		Float y2 = V::Add(V::Sub(y0, V::ConvertToFloat(j2)), V::Set1(2 * G3));
+		Float z2 = V::Add(V::Sub(z0, V::ConvertToFloat(k2)), V::Set1(2 * G3));
+		Float x3 = V::Add(V::Sub(x0, V::Set1(FN_DECIMAL(1))), V::Set1(3 * G3));
+		Float y3 = V::Add(V::Sub(y0, V::Set1(FN_DECIMAL(1))), V::Set1(3 * G3));
+		Float z3 = V::Add(V::Sub(z0, V::Set1(FN_DECIMAL(1))), V::Set1(3 * G3));
+
+		Float n0 = SimplexCorner(lattice, i, j, k, x0, y0, z0);
+		Float n1 = SimplexCorner(lattice, V::Add(i, i1), V::Add(j, j1), V::Add(k, k1), x1, y1, z1);
+		Float n2 = SimplexCorner(lattice, V::Add(i, i2), V::Add(j, j2), V::Add(k, k2), x2, y2, z2);
+		Float n3 = SimplexCorner(lattice, V::Add(i, one), V::Add(j, one), V::Add(k, one), x3, y3, z3);
+
+		StoreRow(out + ix, V::Mul(V::Set1(FN_DECIMAL(32)), V::Add(V::Add(V::Add(n0, n1), n2), n3)), count - ix);
+	}
+}
+
+static inline Int WhiteNoiseHash(Float f)
+{
+	Int bits = V::CastToInt(f);
+	return V::Xor(bits, V::ShiftRightArithmetic16(bits));
+}
+
+static inline Float ValCoordV(Int n)
+{
+	return V::Div(V::ConvertToFloat(V::Mul(V::Mul(V::Mul(n, n), n), V::Set1(60493))), V::Set1(FN_DECIMAL(2147483648)));
+}
+
+static void WhiteNoiseRow(const GridLattice& lattice, FN_DECIMAL* out, FN_DECIMAL originX, FN_DECIMAL stepX, int count, FN_DECIMAL y)
+{
+	Int seed = V::Set1(lattice.seed);
+	Int yHash = V::Set1(Y_PRIME * WhiteNoiseBits(y));
+
+	for (int ix = 0; ix < count; ix += V::LANES)
+	{
+		Int x = WhiteNoiseHash(SampleX(originX, stepX, ix));
+		StoreRow(out + ix, ValCoordV(V::Xor(V::Xor(seed, V::Mul(V::Set1(X_PRIME), x)), yHash)), count - ix);
+	}
+}
+
+static void WhiteNoiseRow(const GridLattice& lattice, FN_DECIMAL* out, FN_DECIMAL originX, FN_DECIMAL stepX, int count, FN_DECIMAL y, FN_DECIMAL z)
+{
+	Int seed = V::Set1(lattice.seed);
+	Int yHash = V::Set1(Y_PRIME * WhiteNoiseBits(y));
+	Int zHash = V::Set1(Z_PRIME * WhiteNoiseBits(z));
+
+	for (int ix = 0; ix < count; ix += V::LANES)
+	{
+		Int x = WhiteNoiseHash(SampleX(originX, stepX, ix));
+		StoreRow(out + ix, ValCoordV(V::Xor(V::Xor(V::Xor(seed, V::Mul(V::Set1(X_PRIME), x)), yHash), zHash)), count - ix);
+	}
+}
@@ -0,0 +1,6 @@
+#include "block.h"
+
+const float BlockFace::SCALAR_X = 16.0f / 256.0f;
+const float BlockFace::SCALAR_Y = 16.0f / 256.0f;
+
+std::vector<Block> Blocks::blocks = {};
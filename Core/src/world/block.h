@@ -0,0 +1,81 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+
+struct BlockFace {
+	// Size of one tile of the block texture atlas in texture coordinates
+	static const float SCALAR_X, SCALAR_Y;
+
+	glm::vec2 uv = glm::vec2(); // "NULL" texture
+	// Position of the tile in the atlas, uv is tile * SCALAR
+	glm::u8vec2 tile = glm::u8vec2();
+
+	BlockFace() {}
+	BlockFace(glm::ivec2 uv) : uv(glm::vec2(uv.x * BlockFace::SCALAR_X, uv.y * BlockFace::SCALAR_Y)), tile(uv) {}
+};
+
+struct Block {
+	BlockFace front = {};
+	BlockFace back = {};
+	BlockFace top = {};
+	BlockFace bottom = {};
+	BlockFace right = {};
+	BlockFace left = {};
+
+	static inline Block create(const BlockFace all) {
+		return {
+			.front = all,
+			.back = all,
+			.top = all,
+			.bottom = all,
+			.right = all,
+			.left = all
+		};
+	}
+	static inline Block create(const BlockFace side, const BlockFace top, const BlockFace bottom) {
+		return {
+			.front = side,
+			.back = side,
+			.top = top,
+			.bottom = bottom,
+			.right = side,
+			.left = side
+		};
+	}
+	static inline Block create(const BlockFace horizontal, const BlockFace vertical) {
+		return {
+			.front = horizontal,
+			.back = horizontal,
+			.top = vertical,
+			.bottom = vertical,
+			.right = horizontal,
+			.left = horizontal
+		};
+	}
+};
+class Blocks {
+private:
+	static std::vector<Block> blocks;
+public:
+	static void registerEntry(const Block block) {
+		Blocks::blocks.push_back(block);
+	}
+	static const Block* getEntry(uint8_t id) {
+		id--;
+
+		if (id < 0 || id >= Blocks::blocks.size()) {
+			return nullptr;
+		}
+
+		return &Blocks::blocks[id];
+	}
+
+	// The terrain blocks, ids 1 grass, 2 stone, 3 bedrock and 4 dirt
+	static void registerDefaults() {
+		Blocks::registerEntry(Block::create(BlockFace(glm::ivec2(3, 15)), BlockFace(glm::ivec2(0, 15)), BlockFace(glm::ivec2(2, 15))));
+		Blocks::registerEntry(Block::create(BlockFace(glm::ivec2(1, 15))));
+		Blocks::registerEntry(Block::create(BlockFace(glm::ivec2(1, 14))));
+		Blocks::registerEntry(Block::create(BlockFace(glm::ivec2(2, 15))));
+	}
+};
@@ -0,0 +1,98 @@
+#include "chunk.h"
+
+#include <algorithm>
+
+void Chunk::create(const glm::ivec3& position, size_t chunksY, const ChunkColumn* column) {
+	if (this->created || this->generator == nullptr) return;
+
+	std::unique_ptr<ChunkColumn> ownColumn;
+	if (column == nullptr) {
+		ownColumn = std::make_unique<ChunkColumn>();
+		this->generator->createColumn(glm::ivec2(position.x, position.z), *ownColumn);
+
+		column = ownColumn.get();
+		this->timings = column->timings;
+	}
+	else {
+		this->timings = column->timings / static_cast<double>(glm::max<size_t>(chunksY, 1));
+	}
+
+	this->position = position;
+	this->created = true;
+
+	const SurfaceStage* surface = this->generator->getSurface();
+	int64_t minY = static_cast<int64_t>(this->position.y) * Chunk::HEIGHT;
+
+	// Height bounds pre-pass: a chunk above every column is plain air, one the surface stage fills with a single block stays uniform unless a carver reaches it
+	int maxHeight = 0;
+	uint8_t surfaceBlock = 0;
+
+	this->timings.surface += TerrainTimings::measure([&]() {
+		bool uniform = true;
+
+		for (uint16_t x = 0; x < Chunk::WIDTH; x++) {
+			for (uint16_t z = 0; z < Chunk::LENGTH; z++) {
+				int height = static_cast<int>(column->getHeight(x, z) - minY);
+				maxHeight = glm::max(maxHeight, glm::clamp<int>(height, 0, Chunk::HEIGHT));
+
+				if (!uniform) continue;
+
+				uint8_t block = surface->getUniformBlock(*column, x, z, minY, minY + Chunk::HEIGHT - 1);
+				uniform = block != 0 && (surfaceBlock == 0 || block == surfaceBlock);
+				surfaceBlock = block;
+			}
+		}
+
+		if (!uniform) surfaceBlock = 0;
+	});
+
+	if (maxHeight == 0 && this->position.y != 0) {
+		this->uniformBlock = 0;
+		return;
+	}
+
+	// Carved voxels of everything that can hold terrain, laid out as x + y * WIDTH + z * WIDTH * maxHeight
+	std::vector<uint8_t> carved;
+	this->timings.carvers += TerrainTimings::measure([&]() {
+		this->generator->carve(
+			glm::i64vec3(this->position) * glm::i64vec3(Chunk::WIDTH, Chunk::HEIGHT, Chunk::LENGTH),
+			Chunk::WIDTH, maxHeight, Chunk::LENGTH,
+			carved
+		);
+	});
+
+	if (surfaceBlock != 0 && std::none_of(carved.begin(), carved.end(), [](uint8_t voxel) { return voxel != 0; })) {
+		this->uniformBlock = surfaceBlock;
+		return;
+	}
+
+	this->timings.surface += TerrainTimings::measure([&]() {
+		this->uniformBlock = 0;
+		this->materialize();
+
+		for (uint16_t x = 0; x < Chunk::WIDTH; x++) {
+			for (uint16_t z = 0; z < Chunk::LENGTH; z++) {
+				int clampedHeight = glm::clamp<int>(static_cast<int>(column->getHeight(x, z) - minY), 0, Chunk::HEIGHT);
+
+				for (uint16_t y = 0; y < clampedHeight; y++) {
+					if (carved[x + (y + z * maxHeight) * Chunk::WIDTH]) continue;
+					// Nobody can hold a snapshot of a chunk that is still being created, so it is written without locking
+					this->blocks[INDEX_FROM_XYZ(x, y, z, Chunk::WIDTH, Chunk::LENGTH)] = surface->getBlock(*column, x, z, minY + y);
+				}
+			}
+		}
+	});
+}
+
+uint64_t Chunk::hash() const {
+	uint64_t hash = 14695981039346656037ull;
+	for (uint16_t y = 0; y < Chunk::HEIGHT; y++) {
+		for (uint16_t z = 0; z < Chunk::LENGTH; z++) {
+			for (uint16_t x = 0; x < Chunk::WIDTH; x++) {
+				hash = (hash ^ this->getBlock(x, y, z)) * 1099511628211ull;
+			}
+		}
+	}
+
+	return hash;
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include <cstring>
+
+#include "terrain.h"
+
+#define INDEX_FROM_XYZ(X, Y, Z, WIDTH, LENGTH) ((X) + (Z) * (WIDTH) + (Y) * (WIDTH) * (LENGTH))
+
+// The voxels of a chunk as they were at one version, they never change however the chunk is edited afterwards
+// Any thread can read a snapshot while the chunk keeps changing, a default one is all air
+class ChunkSnapshot {
+private:
+	std::shared_ptr<const uint8_t[]> blocks;
+	uint8_t uniformBlock = 0;
+	uint32_t version = 0;
+public:
+	ChunkSnapshot() = default;
+	ChunkSnapshot(std::shared_ptr<const uint8_t[]> blocks, uint8_t uniformBlock, uint32_t version) : blocks(std::move(blocks)), uniformBlock(uniformBlock), version(version) {}
+
+	bool isUniform() const {
+		return this->blocks == nullptr;
+	}
+	uint8_t getUniformBlock() const {
+		return this->uniformBlock;
+	}
+	const uint8_t* getBlocks() const {
+		return this->blocks.get();
+	}
+	uint32_t getVersion() const {
+		return this->version;
+	}
+};
+
+// setBlock() and getBlock() belong to one thread (the one editing the world), every other thread reads through snapshot()
+class Chunk {
+private:
+	// nullptr while the chunk is uniform, every voxel is then uniformBlock
+	// Once a snapshot shares it (shared), the next edit writes to a copy instead (copy on write)
+	std::shared_ptr<uint8_t[]> blocks;
+	uint8_t uniformBlock = 0;
+	bool created = false;
+
+	// Guards blocks and shared against snapshot() while an edit swaps or writes them, version counts the edits
+	// shared is not use_count() > 1: that count is read relaxed, so a snapshot dropped on another thread would not be ordered before the write
+	mutable std::mutex mutex;
+	mutable bool shared = false;
+	std::atomic<uint32_t> version = 0;
+
+	glm::ivec3 position = glm::ivec3();
+
+	const TerrainGenerator* generator = nullptr;
+	TerrainTimings timings;
+
+	void materialize() {
+		if (this->blocks != nullptr) return;
+
+		this->blocks = std::make_shared_for_overwrite<uint8_t[]>(Chunk::WIDTH * Chunk::HEIGHT * Chunk::LENGTH);
+		memset(this->blocks.get(), this->uniformBlock, Chunk::WIDTH * Chunk::HEIGHT * Chunk::LENGTH);
+	}
+public:
+	static const uint16_t WIDTH = ChunkColumn::WIDTH, HEIGHT = 32, LENGTH = ChunkColumn::LENGTH;
+
+	void setGenerator(const TerrainGenerator* generator) {
+		this->generator = generator;
+	}
+	// Without a shared column the heightmap is recomputed just for this chunk
+	// A shared column is charged to the chunksY chunks of its stack in equal parts
+	void create(const glm::ivec3& position, size_t chunksY, const ChunkColumn* column = nullptr);
+
+	// Returns whether the block changed, only then the version goes up
+	bool setBlock(uint16_t x, uint16_t y, uint16_t z, uint8_t block) {
+		if (!this->created || x >= Chunk::WIDTH || y >= Chunk::HEIGHT || z >= Chunk::LENGTH) return false;
+		if (this->getBlock(x, y, z) == block) return false;
+
+		std::lock_guard<std::mutex> lock(this->mutex);
+		if (this->blocks == nullptr) this->materialize();
+		else if (this->shared) {
+			std::shared_ptr<uint8_t[]> copy = std::make_shared_for_overwrite<uint8_t[]>(Chunk::WIDTH * Chunk::HEIGHT * Chunk::LENGTH);
+			memcpy(copy.get(), this->blocks.get(), Chunk::WIDTH * Chunk::HEIGHT * Chunk::LENGTH);
+			this->blocks = std::move(copy);
+		}
+		this->shared = false;
+
+		this->blocks[INDEX_FROM_XYZ(x, y, z, Chunk::WIDTH, Chunk::LENGTH)] = block;
+		this->version++;
+
+		return true;
+	}
+	uint8_t getBlock(uint16_t x, uint16_t y, uint16_t z) const {
+		if (x >= Chunk::WIDTH || y >= Chunk::HEIGHT || z >= Chunk::LENGTH) return 0;
+		if (this->blocks == nullptr) return this->uniformBlock;
+
+		return this->blocks[INDEX_FROM_XYZ(x, y, z, Chunk::WIDTH, Chunk::LENGTH)];
+	}
+
+	bool isUniform() const {
+		return this->blocks == nullptr;
+	}
+	// Only meaningful while isUniform()
+	uint8_t getUniformBlock() const {
+		return this->uniformBlock;
+	}
+	// Every voxel laid out as INDEX_FROM_XYZ(x, y, z, WIDTH, LENGTH), nullptr while isUniform()
+	const uint8_t* getBlocks() const {
+		return this->blocks.get();
+	}
+
+	// The voxels as they are now, without copying them
+	ChunkSnapshot snapshot() const {
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->shared = this->blocks != nullptr;
+
+		return ChunkSnapshot(this->blocks, this->uniformBlock, this->version);
+	}
+	uint32_t getVersion() const {
+		return this->version;
+	}
+
+	glm::ivec3 getPosition() const {
+		return this->position;
+	}
+	const TerrainTimings& getTimings() const {
+		return this->timings;
+	}
+
+	// FNV-1a over every voxel, the same for uniform and materialized chunks with equal content
+	uint64_t hash() const;
+};
@@ -0,0 +1,84 @@
+#include "collision.h"
+
+float Collision::clipVelocity(const glm::vec3& minA, const glm::vec3& maxA, const glm::vec3& minB, const glm::vec3& maxB, float velocity, size_t axis) {
+	int x = axis;
+	int y = x + 1 >= 3 ? 0 : x + 1;
+	int z = y + 1 >= 3 ? 0 : y + 1;
+
+	if (minA[y] >= maxB[y] || maxA[y] <= minB[y]) {
+		return velocity;
+	}
+	if (minA[z] >= maxB[z] || maxA[z] <= minB[z]) {
+		return velocity;
+	}
+
+	if (velocity > 0.0f && maxA[x] <= minB[x]) {
+		float difference = minB[x] - maxA[x] - 0.01f;
+		if (difference < velocity) {
+			return difference;
+		}
+	}
+	if (velocity < 0.0f && minA[x] >= maxB[x]) {
+		float difference = maxB[x] - minA[x] + 0.01f;
+		if (difference > velocity) {
+			return difference;
+		}
+	}
+
+	return velocity;
+}
+
+glm::vec3 Collision::move(const ChunkGenerator& chunkGenerator, glm::vec3& position, const glm::vec3& scale, const glm::vec3& motion) {
+	return Collision::moveRelative(chunkGenerator, glm::i64vec3(0), position, scale, motion);
+}
+
+glm::vec3 Collision::move(const ChunkGenerator& chunkGenerator, glm::dvec3& position, const glm::vec3& scale, const glm::vec3& motion) {
+	glm::i64vec3 origin = glm::i64vec3(glm::floor(position));
+	glm::vec3 relative = glm::vec3(position - glm::dvec3(origin));
+
+	glm::vec3 applied = Collision::moveRelative(chunkGenerator, origin, relative, scale, motion);
+	position = glm::dvec3(origin) + glm::dvec3(relative);
+
+	return applied;
+}
+
+glm::vec3 Collision::moveRelative(const ChunkGenerator& chunkGenerator, const glm::i64vec3& origin, glm::vec3& position, const glm::vec3& scale, const glm::vec3& motion) {
+	glm::vec3 applied = motion;
+
+	for (int axis : { 1, 0, 2 }) {
+		glm::vec3 boxMin = position;
+		glm::vec3 boxMax = position + scale;
+
+		// Blocks the box can touch, widened along the moving axis by the motion
+		glm::ivec3 from = glm::ivec3(glm::floor(boxMin));
+		glm::ivec3 to = glm::ivec3(glm::floor(boxMax));
+
+		float velocity = glm::abs(applied[axis]);
+		from[axis] = static_cast<int>(glm::floor(boxMin[axis] - velocity)) - 1;
+		to[axis] = static_cast<int>(glm::floor(boxMax[axis] + velocity)) + 1;
+
+		for (int x = from.x; x <= to.x; ++x) {
+			for (int y = from.y; y <= to.y; ++y) {
+				for (int z = from.z; z <= to.z; ++z) {
+					// Everything outside of what getBlock() can address is air
+					glm::i64vec3 block = origin + glm::i64vec3(x, y, z);
+					if (glm::any(glm::lessThan(block, glm::i64vec3(0))) || glm::any(glm::greaterThan(block, glm::i64vec3(UINT32_MAX)))) {
+						continue;
+					}
+					if (chunkGenerator.getBlock(static_cast<uint32_t>(block.x), static_cast<uint32_t>(block.y), static_cast<uint32_t>(block.z)) == 0) {
+						continue;
+					}
+
+					glm::vec3 blockMin = glm::vec3(x, y, z);
+					glm::vec3 blockMax = glm::vec3(blockMin) + 1.0f;
+
+					applied[axis] = Collision::clipVelocity(boxMin, boxMax, blockMin, blockMax, applied[axis], axis);
+				}
+			}
+		}
+
+		position[axis] += applied[axis];
+	}
+
+	return applied;
+}
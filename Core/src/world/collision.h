@@ -0,0 +1,17 @@
+#pragma once
+#include <glm/glm.hpp>
+
+#include "generator.h"
+
+struct Collision {
+	static float clipVelocity(const glm::vec3& minA, const glm::vec3& maxA, const glm::vec3& minB, const glm::vec3& maxB, float velocity, size_t axis);
+
+	// Moves the box at position (its min corner) of size scale by motion, stopping at solid blocks, one axis at a time (y, x, then z)
+	// Returns the motion that was applied, components that differ from motion hit a block
+	static glm::vec3 move(const ChunkGenerator& chunkGenerator, glm::vec3& position, const glm::vec3& scale, const glm::vec3& motion);
+	// The same for a position in double, the box is collided in float relative to the block it starts in, so it stays precise anywhere
+	static glm::vec3 move(const ChunkGenerator& chunkGenerator, glm::dvec3& position, const glm::vec3& scale, const glm::vec3& motion);
+private:
+	// move() for a position relative to the block origin, blocks are looked up at origin + their relative coordinate
+	static glm::vec3 moveRelative(const ChunkGenerator& chunkGenerator, const glm::i64vec3& origin, glm::vec3& position, const glm::vec3& scale, const glm::vec3& motion);
+};
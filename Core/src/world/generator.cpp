@@ -0,0 +1,420 @@
+#include "generator.h"
+
+#include <algorithm>
+
+void ChunkGenerator::create(bool useColumnCache, bool buildMeshes) {
+	JobGraph graph;
+	std::vector<uint32_t> columnJobs(ChunkGenerator::CHUNKS_X * ChunkGenerator::CHUNKS_Z);
+
+	// Columns nearest to the view first, jobs start in the order they are added so the terrain around the player is done first
+	std::vector<glm::ivec2> columns;
+	for (int x = 0; x < ChunkGenerator::CHUNKS_X; x++) {
+		for (int z = 0; z < ChunkGenerator::CHUNKS_Z; z++) {
+			columns.push_back(glm::ivec2(x, z));
+		}
+	}
+	glm::ivec2 viewColumn = glm::ivec2(this->viewChunkX.load(), this->viewChunkZ.load());
+	std::stable_sort(columns.begin(), columns.end(), [&](const glm::ivec2& a, const glm::ivec2& b) {
+		glm::ivec2 toA = a - viewColumn, toB = b - viewColumn;
+		return toA.x * toA.x + toA.y * toA.y < toB.x * toB.x + toB.y * toB.y;
+	});
+
+	for (const glm::ivec2& column : columns) {
+		int x = column.x, z = column.y;
+
+		columnJobs[x + z * ChunkGenerator::CHUNKS_X] = graph.add([this, x, z, useColumnCache, buildMeshes]() {
+			// The column only lives while its vertical stack of chunks is generated
+			ChunkColumn column;
+			if (useColumnCache) this->terrain.createColumn(glm::ivec2(x, z), column);
+
+			for (size_t y = 0; y < ChunkGenerator::CHUNKS_Y; y++) {
+				size_t id = INDEX_FROM_XYZ(x, y, z, ChunkGenerator::CHUNKS_X, ChunkGenerator::CHUNKS_Z);
+
+				this->chunks[id].setGenerator(&this->terrain);
+				this->chunks[id].create(glm::ivec3(x, y, z), ChunkGenerator::CHUNKS_Y, useColumnCache ? &column : nullptr);
+
+				// Meshes built below are not queued, updateMeshes() would only find them built already
+				this->chunkMeshes[id].connect(&this->chunks[id]);
+				if (buildMeshes) this->chunkMeshes[id].markDirty();
+				else this->markMeshDirty(id);
+			}
+		});
+	}
+
+	if (buildMeshes) {
+		this->updateLods();
+
+		// A mesh reads the border of all 26 chunks around it, so it waits for the 3 x 3 columns it touches
+		for (const glm::ivec2& column : columns) {
+			int x = column.x, z = column.y;
+
+			std::vector<uint32_t> dependencies;
+			for (int neighborX = std::max(x - 1, 0); neighborX <= std::min(x + 1, static_cast<int>(CHUNKS_X) - 1); neighborX++) {
+				for (int neighborZ = std::max(z - 1, 0); neighborZ <= std::min(z + 1, static_cast<int>(CHUNKS_Z) - 1); neighborZ++) {
+					dependencies.push_back(columnJobs[neighborX + neighborZ * ChunkGenerator::CHUNKS_X]);
+				}
+			}
+
+			for (int y = 0; y < ChunkGenerator::CHUNKS_Y; y++) {
+				graph.add([this, x, y, z]() {
+					this->chunkMeshes[INDEX_FROM_XYZ(x, y, z, ChunkGenerator::CHUNKS_X, ChunkGenerator::CHUNKS_Z)].update(this->getNeighbors(x, y, z));
+				}, dependencies);
+			}
+		}
+	}
+
+	this->jobs.run(graph);
+
+	if (buildMeshes) {
+		for (size_t id = 0; id < CHUNKS_X * CHUNKS_Y * CHUNKS_Z; id++) {
+			this->publishMesh(id);
+		}
+
+		// updateLods() queued meshes that were built since, they are dropped so neither a rebuild nor its latency is counted
+		std::lock_guard<std::mutex> lock(this->remeshMutex);
+		std::erase_if(this->remeshQueue, [this](uint32_t id) {
+			if (this->chunkMeshes[id].isDirty()) return false;
+
+			this->remeshQueued[id] = 0;
+			this->remeshEdited[id] = 0;
+			return true;
+		});
+	}
+}
+
+void ChunkGenerator::queueMesh(size_t id, bool edit) {
+	this->chunkMeshes[id].markDirty();
+	if (edit) this->remeshEdited[id] = 1;
+	if (this->remeshQueued[id]) return;
+
+	this->remeshQueued[id] = 1;
+	this->remeshQueuedAt[id] = std::chrono::steady_clock::now();
+	this->remeshQueue.push_back(static_cast<uint32_t>(id));
+}
+
+void ChunkGenerator::notifyRemesh() {
+	this->remeshCondition.notify_one();
+}
+
+void ChunkGenerator::markMeshDirty(size_t id) {
+	{
+		std::lock_guard<std::mutex> lock(this->remeshMutex);
+		this->queueMesh(id);
+	}
+	this->notifyRemesh();
+}
+
+void ChunkGenerator::markMeshesDirty(int x, int y, int z, const glm::ivec3& from, const glm::ivec3& to, bool edit) {
+	{
+		std::lock_guard<std::mutex> lock(this->remeshMutex);
+
+		for (int offsetY = from.y; offsetY <= to.y; offsetY++) {
+			for (int offsetZ = from.z; offsetZ <= to.z; offsetZ++) {
+				for (int offsetX = from.x; offsetX <= to.x; offsetX++) {
+					int neighborX = x + offsetX, neighborY = y + offsetY, neighborZ = z + offsetZ;
+					if (neighborX < 0 || neighborY < 0 || neighborZ < 0 || neighborX >= CHUNKS_X || neighborY >= CHUNKS_Y || neighborZ >= CHUNKS_Z) continue;
+
+					this->queueMesh(INDEX_FROM_XYZ(neighborX, neighborY, neighborZ, CHUNKS_X, CHUNKS_Z), edit);
+				}
+			}
+		}
+	}
+	this->notifyRemesh();
+}
+
+void ChunkGenerator::setGreedyMeshing(bool greedy) {
+	{
+		std::lock_guard<std::mutex> lock(this->remeshMutex);
+
+		for (size_t i = 0; i < CHUNKS_X * CHUNKS_Y * CHUNKS_Z; i++) {
+			this->chunkMeshes[i].setGreedy(greedy);
+			this->queueMesh(i);
+		}
+	}
+	this->notifyRemesh();
+}
+
+void ChunkGenerator::setLodEnabled(bool enabled) {
+	this->lodEnabled = enabled;
+
+	{
+		std::lock_guard<std::mutex> lock(this->remeshMutex);
+		this->lodPending = true;
+	}
+	this->notifyRemesh();
+}
+
+void ChunkGenerator::setViewPosition(const glm::dvec3& position) {
+	{
+		std::lock_guard<std::mutex> lock(this->viewMutex);
+		this->viewPosition = position;
+	}
+
+	int chunkX = static_cast<int>(floor(position.x / Chunk::WIDTH));
+	int chunkY = static_cast<int>(floor(position.y / Chunk::HEIGHT));
+	int chunkZ = static_cast<int>(floor(position.z / Chunk::LENGTH));
+	if (chunkX == this->viewChunkX && chunkY == this->viewChunkY && chunkZ == this->viewChunkZ) return;
+
+	this->viewChunkX = chunkX;
+	this->viewChunkY = chunkY;
+	this->viewChunkZ = chunkZ;
+	if (!this->lodEnabled) return;
+
+	{
+		std::lock_guard<std::mutex> lock(this->remeshMutex);
+		this->lodPending = true;
+	}
+	this->notifyRemesh();
+}
+
+void ChunkGenerator::setViewFrustum(const Frustum& frustum) {
+	std::lock_guard<std::mutex> lock(this->viewMutex);
+	this->viewFrustum = frustum;
+}
+
+float ChunkGenerator::getPriority(uint32_t id, const glm::dvec3& viewPosition, const Frustum& frustum, bool& visible) const {
+	const glm::dvec3 chunkSize = glm::dvec3(Chunk::WIDTH, Chunk::HEIGHT, Chunk::LENGTH);
+	glm::dvec3 min = glm::dvec3(id % CHUNKS_X, id / (CHUNKS_X * CHUNKS_Z), id / CHUNKS_X % CHUNKS_Z) * chunkSize - viewPosition;
+
+	visible = frustum.classify(glm::vec3(min), glm::vec3(min + chunkSize)) != Frustum::Outside;
+
+	return static_cast<float>(glm::length((min + chunkSize * 0.5) / chunkSize)) + (visible ? 0.0f : ChunkGenerator::VIEW_PENALTY);
+}
+
+uint8_t ChunkGenerator::getLod(int x, int y, int z) const {
+	int distance = std::max({ abs(x - this->viewChunkX), abs(y - this->viewChunkY), abs(z - this->viewChunkZ) });
+
+	uint8_t lod = 0;
+	while (lod < ChunkMesh::MAX_LOD && distance > this->lodDistances[lod]) lod++;
+
+	return lod;
+}
+
+void ChunkGenerator::updateLods() {
+	for (int x = 0; x < ChunkGenerator::CHUNKS_X; x++) {
+		for (int y = 0; y < ChunkGenerator::CHUNKS_Y; y++) {
+			for (int z = 0; z < ChunkGenerator::CHUNKS_Z; z++) {
+				ChunkMesh& mesh = this->chunkMeshes[INDEX_FROM_XYZ(x, y, z, ChunkGenerator::CHUNKS_X, ChunkGenerator::CHUNKS_Z)];
+
+				uint8_t lod = this->lodEnabled ? this->getLod(x, y, z) : 0;
+				if (lod == mesh.getLod()) continue;
+
+				mesh.setLod(lod);
+				this->markMeshesDirty(x, y, z, glm::ivec3(-1), glm::ivec3(1));
+			}
+		}
+	}
+}
+
+ChunkNeighbors ChunkGenerator::getNeighbors(int x, int y, int z) const {
+	const ChunkMesh& mesh = this->chunkMeshes[INDEX_FROM_XYZ(x, y, z, ChunkGenerator::CHUNKS_X, ChunkGenerator::CHUNKS_Z)];
+	ChunkNeighbors neighbors;
+
+	for (int offsetY = -1; offsetY <= 1; offsetY++) {
+		for (int offsetZ = -1; offsetZ <= 1; offsetZ++) {
+			for (int offsetX = -1; offsetX <= 1; offsetX++) {
+				int neighborX = x + offsetX, neighborY = y + offsetY, neighborZ = z + offsetZ;
+				if (neighborX < 0 || neighborY < 0 || neighborZ < 0 || neighborX >= CHUNKS_X || neighborY >= CHUNKS_Y || neighborZ >= CHUNKS_Z) continue;
+
+				// A neighbor at another level of detail reads as air, both sides then keep their faces along the seam
+				size_t id = INDEX_FROM_XYZ(neighborX, neighborY, neighborZ, ChunkGenerator::CHUNKS_X, ChunkGenerator::CHUNKS_Z);
+				if (this->chunkMeshes[id].getLod() == mesh.getLod()) neighbors.at(offsetX, offsetY, offsetZ) = this->chunks[id].snapshot();
+			}
+		}
+	}
+
+	return neighbors;
+}
+
+void ChunkGenerator::updateMeshes() {
+	while (true) {
+		bool lodPending;
+		{
+			std::lock_guard<std::mutex> lock(this->remeshMutex);
+
+			lodPending = this->lodPending;
+			this->lodPending = false;
+		}
+
+		// Levels of detail first, a mesh builds its seams from the levels of its neighbors
+		if (lodPending) this->updateLods();
+
+		// The view this slice is ordered by, it is taken again for every slice so a moving camera only costs one pass over the queue
+		glm::dvec3 viewPosition;
+		Frustum frustum;
+		{
+			std::lock_guard<std::mutex> lock(this->viewMutex);
+
+			viewPosition = this->viewPosition;
+			frustum = this->viewFrustum;
+		}
+
+		// The queue is taken as a whole, meshes dirtied from here on are queued again
+		this->remeshOrder.clear();
+		{
+			std::lock_guard<std::mutex> lock(this->remeshMutex);
+			if (this->remeshQueue.empty()) return;
+
+			this->remeshBatch.swap(this->remeshQueue);
+			for (uint32_t id : this->remeshBatch) {
+				this->remeshOrder.push_back({ this->remeshEdited[id] ? -ChunkGenerator::EDIT_BONUS : 0.0f, id });
+			}
+		}
+		this->remeshBatch.clear();
+
+		for (std::pair<float, uint32_t>& entry : this->remeshOrder) {
+			bool visible;
+			entry.first += this->getPriority(entry.second, viewPosition, frustum, visible);
+		}
+
+		// Only the slice is sorted, the rest goes back into the queue as it is and is ordered again with the next view
+		size_t count = std::min(ChunkGenerator::REMESH_SLICE, this->remeshOrder.size());
+		std::partial_sort(this->remeshOrder.begin(), this->remeshOrder.begin() + count, this->remeshOrder.end());
+
+		this->remeshSlice.clear();
+		{
+			std::lock_guard<std::mutex> lock(this->remeshMutex);
+
+			for (size_t i = count; i < this->remeshOrder.size(); i++) {
+				this->remeshQueue.push_back(this->remeshOrder[i].second);
+			}
+			for (size_t i = 0; i < count; i++) {
+				uint32_t id = this->remeshOrder[i].second;
+
+				this->remeshSlice.push_back({ .id = id, .edited = this->remeshEdited[id] != 0, .visible = false, .built = false, .queuedAt = this->remeshQueuedAt[id] });
+				this->remeshQueued[id] = 0;
+				this->remeshEdited[id] = 0;
+			}
+		}
+
+		// Every dirty mesh only reads chunk snapshots and writes itself, so the slice is built at once, most urgent jobs first
+		JobGraph graph;
+		for (RemeshEntry& entry : this->remeshSlice) {
+			// Only visibility is needed again, for the latency of meshes in view
+			this->getPriority(entry.id, viewPosition, frustum, entry.visible);
+			if (!this->chunkMeshes[entry.id].isDirty()) continue;
+
+			// Every job writes its own entry, the slice is not touched until all of them finished
+			RemeshEntry* built = &entry;
+			graph.add([this, built]() {
+				int x = built->id % CHUNKS_X, z = built->id / CHUNKS_X % CHUNKS_Z, y = built->id / (CHUNKS_X * CHUNKS_Z);
+				built->built = this->chunkMeshes[built->id].update(this->getNeighbors(x, y, z));
+			});
+		}
+
+		this->jobs.run(graph);
+
+		// Published from this thread alone, builtMeshes takes one producer
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		std::lock_guard<std::mutex> lock(this->remeshMutex);
+
+		for (const RemeshEntry& entry : this->remeshSlice) {
+			this->publishMesh(entry.id);
+			// Meshes that were already built (by create() or an earlier slice) kept nobody waiting
+			if (!entry.built) continue;
+
+			double milliseconds = std::chrono::duration<double, std::milli>(now - entry.queuedAt).count();
+			if (entry.edited) this->editLatency.add(milliseconds);
+			if (entry.visible) this->visibleLatency.add(milliseconds);
+		}
+	}
+}
+
+void ChunkGenerator::publishMesh(size_t id) {
+	if (this->chunkMeshes[id].publish()) this->builtMeshes.push(static_cast<uint32_t>(id));
+}
+
+bool ChunkGenerator::takeMesh(uint32_t& id, ChunkMeshData& data) {
+	while (this->builtMeshes.pop(id)) {
+		if (!this->chunkMeshes[id].take(data)) continue;
+
+		// Edited while it was built, the build of the newer version follows
+		if (data.version == this->chunkMeshes[id].getVersion()) return true;
+	}
+
+	return false;
+}
+
+void ChunkGenerator::run(const std::function<bool()>& isRunning) {
+	while (isRunning()) {
+		{
+			std::unique_lock<std::mutex> lock(this->remeshMutex);
+			this->remeshCondition.wait(lock, [this]() { return !this->remeshQueue.empty() || this->lodPending || this->stopping; });
+
+			if (this->stopping) return;
+		}
+
+		this->updateMeshes();
+	}
+}
+
+void ChunkGenerator::stop() {
+	{
+		std::lock_guard<std::mutex> lock(this->remeshMutex);
+		this->stopping = true;
+	}
+	this->remeshCondition.notify_all();
+}
+
+void ChunkGenerator::takeRemeshLatency(RemeshLatency& edits, RemeshLatency& visible) {
+	std::lock_guard<std::mutex> lock(this->remeshMutex);
+
+	edits = this->editLatency;
+	visible = this->visibleLatency;
+	this->editLatency = RemeshLatency();
+	this->visibleLatency = RemeshLatency();
+}
+
+void ChunkGenerator::setBlock(uint32_t x, uint32_t y, uint32_t z, uint8_t block) {
+	int chunkX = static_cast<int>(floor(x / Chunk::WIDTH));
+	int chunkY = static_cast<int>(floor(y / Chunk::HEIGHT));
+	int chunkZ = static_cast<int>(floor(z / Chunk::LENGTH));
+
+	if (chunkX < 0 || chunkY < 0 || chunkZ < 0 || chunkX >= CHUNKS_X || chunkY >= CHUNKS_Y || chunkZ >= CHUNKS_Z) return;
+	size_t index = INDEX_FROM_XYZ(chunkX, chunkY, chunkZ, CHUNKS_X, CHUNKS_Z);
+
+	uint16_t localX = x - chunkX * Chunk::WIDTH;
+	uint16_t localY = y - chunkY * Chunk::HEIGHT;
+	uint16_t localZ = z - chunkZ * Chunk::LENGTH;
+
+	if (!this->chunks[index].setBlock(localX, localY, localZ, block)) return;
+	// Every mesh whose border holds the block reads it, for faces or ambient occlusion
+	// Only neighbors at the same level of detail read the border, it is one cell of 2 ^ lod voxels thick
+	int cell = 1 << this->chunkMeshes[index].getLod();
+	this->markMeshesDirty(chunkX, chunkY, chunkZ,
+		glm::ivec3(localX < cell ? -1 : 0, localY < cell ? -1 : 0, localZ < cell ? -1 : 0),
+		glm::ivec3(localX >= Chunk::WIDTH - cell ? 1 : 0, localY >= Chunk::HEIGHT - cell ? 1 : 0, localZ >= Chunk::LENGTH - cell ? 1 : 0),
+		true
+	);
+}
+
+uint8_t ChunkGenerator::getBlock(uint32_t x, uint32_t y, uint32_t z) const {
+	int chunkX = static_cast<int>(floor(x / Chunk::WIDTH));
+	int chunkY = static_cast<int>(floor(y / Chunk::HEIGHT));
+	int chunkZ = static_cast<int>(floor(z / Chunk::LENGTH));
+
+	if (chunkX < 0 || chunkY < 0 || chunkZ < 0 || chunkX >= CHUNKS_X || chunkY >= CHUNKS_Y || chunkZ >= CHUNKS_Z) return 0;
+	
+	return this->chunks[INDEX_FROM_XYZ(chunkX, chunkY, chunkZ, CHUNKS_X, CHUNKS_Z)].getBlock(
+		x - chunkX * Chunk::WIDTH,
+		y - chunkY * Chunk::HEIGHT,
+		z - chunkZ * Chunk::LENGTH
+	);
+}
+
+void ChunkGenerator::createBlob(int x, int y, int z, uint8_t block, int blobSize, std::mt19937* random) {
+	for (int ox = -blobSize; ox < blobSize; ox++) {
+		for (int oy = -blobSize; oy < blobSize; oy++) {
+			for (int oz = -blobSize; oz < blobSize; oz++) {
+				if (glm::length(glm::vec3(ox, oy, oz)) <= blobSize - (random != nullptr ? (*random)() % 10000 / 10000.0f : 0)) {
+					this->setBlock(
+						x + ox,
+						y + oy,
+						z + oz,
+						block
+					);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,166 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include "chunk.h"
+#include "terrain.h"
+#include "../mesh/chunkmesh.h"
+#include "../mesh/frustum.h"
+#include "../jobs/jobsystem.h"
+#include "../jobs/spscqueue.h"
+
+// How long meshes waited from being queued until their build was handed to takeMesh(), in milliseconds
+struct RemeshLatency {
+	size_t count = 0;
+	double total = 0.0, max = 0.0;
+
+	void add(double milliseconds) {
+		this->count++;
+		this->total += milliseconds;
+		this->max = std::max(this->max, milliseconds);
+	}
+	double getAverage() const {
+		return this->count == 0 ? 0.0 : this->total / this->count;
+	}
+};
+
+// Threads: one edits the world (create(), setBlock() and the settings), one meshes it (updateMeshes() or run()) and one takes the meshes (takeMesh())
+// The mesher only reads chunk snapshots, so edits never wait for meshing, and a mesh edited while it was built is rebuilt and its stale build dropped
+class ChunkGenerator {
+private:
+	FastNoise noise;
+	TerrainGenerator terrain;
+	JobSystem jobs;
+
+	// Chunk the view is in, written by the game and read while meshing
+	std::atomic<int> viewChunkX = 0, viewChunkY = 0, viewChunkZ = 0;
+	std::atomic<bool> lodEnabled = false;
+
+	// The exact view, only used to order the remesh queue
+	mutable std::mutex viewMutex;
+	glm::dvec3 viewPosition = glm::dvec3();
+	Frustum viewFrustum;
+
+	// Meshes waiting to be rebuilt, each at most once, run() sleeps on remeshCondition while there are none
+	// remeshEdited marks meshes queued by setBlock() and remeshQueuedAt holds when a mesh was queued first, for the latencies
+	// lodPending is set when the view moved to another chunk or level of detail was switched, the levels are then checked again
+	std::mutex remeshMutex;
+	std::condition_variable remeshCondition;
+	std::vector<uint32_t> remeshQueue, remeshBatch;
+	std::vector<uint8_t> remeshQueued = std::vector<uint8_t>(CHUNKS_X * CHUNKS_Y * CHUNKS_Z, 0);
+	std::vector<uint8_t> remeshEdited = std::vector<uint8_t>(CHUNKS_X * CHUNKS_Y * CHUNKS_Z, 0);
+	std::vector<std::chrono::steady_clock::time_point> remeshQueuedAt = std::vector<std::chrono::steady_clock::time_point>(CHUNKS_X * CHUNKS_Y * CHUNKS_Z);
+	bool lodPending = false, stopping = false;
+	RemeshLatency editLatency, visibleLatency;
+
+	// A mesh of the slice being built, in the order the jobs are added
+	struct RemeshEntry {
+		uint32_t id;
+		bool edited, visible, built;
+		std::chrono::steady_clock::time_point queuedAt;
+	};
+	std::vector<std::pair<float, uint32_t>> remeshOrder;
+	std::vector<RemeshEntry> remeshSlice;
+
+	// Ids of meshes with a published build, a mesh is in it at most once (see ChunkMesh::publish()) so it never fills up
+	SpscQueue<uint32_t> builtMeshes = SpscQueue<uint32_t>(CHUNKS_X * CHUNKS_Y * CHUNKS_Z);
+
+	// Meshes built per slice of updateMeshes(), the queue is ordered again between slices so the next one follows the view
+	static constexpr size_t REMESH_SLICE = 64;
+	// Priority is the distance from the view in chunks, lower first: chunks outside the frustum count as VIEW_PENALTY chunks further away
+	// and meshes queued by an edit EDIT_BONUS chunks closer, so the block the player just placed shows up before the world around it
+	static constexpr float VIEW_PENALTY = 8.0f, EDIT_BONUS = 16.0f;
+
+	// Marks the mesh dirty and queues it if it is not already, remeshMutex has to be held
+	void queueMesh(size_t id, bool edit = false);
+	// Wakes run() up, after the work it should find is queued
+	void notifyRemesh();
+	// Marks the meshes of chunk (x, y, z) + from ... to dirty, offsets in chunks and inclusive
+	void markMeshesDirty(int x, int y, int z, const glm::ivec3& from, const glm::ivec3& to, bool edit = false);
+	// Priority of the mesh of chunk id seen from viewPosition, visible is set to whether it intersects frustum (relative to viewPosition)
+	float getPriority(uint32_t id, const glm::dvec3& viewPosition, const Frustum& frustum, bool& visible) const;
+	uint8_t getLod(int x, int y, int z) const;
+	// Sets the level of detail of every mesh from the view (0 while disabled), the meshes around one that changed level are dirtied
+	void updateLods();
+	// Hands the last build of the mesh to takeMesh(), on the meshing thread
+	void publishMesh(size_t id);
+	// Snapshots of the chunk (x, y, z) and the chunks around it that its mesh reads, neighbors at another level of detail are left out
+	ChunkNeighbors getNeighbors(int x, int y, int z) const;
+public:
+	static const size_t CHUNKS_X = 12, CHUNKS_Y = 8, CHUNKS_Z = 12;
+
+	Chunk* chunks = new Chunk[CHUNKS_X * CHUNKS_Y * CHUNKS_Z]();
+	ChunkMesh* chunkMeshes = new ChunkMesh[CHUNKS_X * CHUNKS_Y * CHUNKS_Z]();
+
+	// The same seed always generates the same world
+	// caveCellSize 1 samples caves per voxel, 4 or 8 trades cave detail for far fewer noise samples
+	// threads generate and mesh chunks, 0 is one per hardware thread
+	ChunkGenerator(int seed, uint16_t caveCellSize = 1, unsigned threads = 0) : noise(seed), terrain(&this->noise, caveCellSize), jobs(threads) {}
+	~ChunkGenerator() {
+		delete[] this->chunks;
+		delete[] this->chunkMeshes;
+	}
+
+	// One job per column of chunks, spread over all threads
+	// buildMeshes also meshes every chunk as soon as the columns around it are generated, instead of waiting for updateMeshes()
+	void create(bool useColumnCache = true, bool buildMeshes = false);
+	// Time every chunk spent in each terrain stage, summed over the world
+	TerrainTimings getTimings() const {
+		TerrainTimings timings;
+		for (size_t i = 0; i < CHUNKS_X * CHUNKS_Y * CHUNKS_Z; i++) {
+			timings += this->chunks[i].getTimings();
+		}
+
+		return timings;
+	}
+	TerrainGenerator& getTerrain() {
+		return this->terrain;
+	}
+	unsigned getThreadCount() const {
+		return this->jobs.getThreadCount();
+	}
+
+	// Switches every chunk mesh between one quad per block face and greedy meshing, all of them are rebuilt
+	void setGreedyMeshing(bool greedy);
+
+	// Meshes up to lodDistances[0] chunks from the view (along every axis) keep full detail, up to lodDistances[1] use lod 1 and so on,
+	// everything further away ChunkMesh::MAX_LOD
+	int lodDistances[ChunkMesh::MAX_LOD] = { 1, 2, 4 };
+
+	// Picks the level of detail of every mesh by its distance from the view, off again every mesh is rebuilt at full detail
+	// Levels change on the meshing thread, with the next updateMeshes()
+	void setLodEnabled(bool enabled);
+	bool isLodEnabled() const {
+		return this->lodEnabled;
+	}
+	// In blocks, levels of detail follow it from the next updateMeshes() on, run() only wakes up when it enters another chunk
+	// The remesh queue is ordered by it (and the frustum) before every slice
+	void setViewPosition(const glm::dvec3& position);
+	// Relative to the view position, like the frustum used for culling, the default one holds everything
+	void setViewFrustum(const Frustum& frustum);
+
+	// Queues the mesh of chunk id for the next updateMeshes()
+	void markMeshDirty(size_t id);
+	// Rebuilds every queued mesh in parallel, in slices of the most urgent ones, until the queue is empty
+	void updateMeshes();
+	// The next mesh built since the last call, false once there is none, builds that are stale already are skipped
+	bool takeMesh(uint32_t& id, ChunkMeshData& data);
+	// Sleeps until meshes are queued and rebuilds them, until stop() is called or isRunning() returns false after a wake up
+	void run(const std::function<bool()>& isRunning);
+	// Makes run() return, also while it sleeps
+	void stop();
+	// Latencies of meshes queued by edits and of meshes in view since the last call
+	void takeRemeshLatency(RemeshLatency& edits, RemeshLatency& visible);
+
+	void setBlock(uint32_t x, uint32_t y, uint32_t z, uint8_t block);
+	uint8_t getBlock(uint32_t x, uint32_t y, uint32_t z) const;
+
+	// Fills a ball of blockSize around (x, y, z) with block, its edge is roughened when random is given
+	void createBlob(int x, int y, int z, uint8_t block, int blobSize = 12, std::mt19937* random = nullptr);
+};
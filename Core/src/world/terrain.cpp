@@ -0,0 +1,182 @@
+#include "terrain.h"
+
+int BiomeShape::sample(const FastNoise* noise, double x, double z) const {
+	double height = this->base;
+
+	if (this->ridged) {
+		NoiseLayer ridgeShape = this->ridge;
+		ridgeShape.amplitude = 1.0;
+
+		height += (pow(glm::max(ridgeShape.sample(noise, x, z), 0.0), this->ridgeExponent) * this->ridge.amplitude - this->erosion.sample(noise, x, z)) * this->ridgeMask.sample(noise, x, z);
+	}
+	for (const NoiseLayer& layer : this->layers) {
+		height += layer.sample(noise, x, z);
+	}
+
+	return static_cast<int>(height);
+}
+
+BiomeHeightmap::BiomeHeightmap() {
+	BiomeShape& hills = this->shapes[ChunkColumn::Hills];
+	hills.layers = { { 1.0, 48.0 }, { 5.0, 12.0 }, { 0.1, 32.0 } };
+
+	BiomeShape& plains = this->shapes[ChunkColumn::Plains];
+	plains.base = 20.0;
+	plains.layers = { { 0.4, 3.0 }, { 0.1, 12.0 } };
+
+	BiomeShape& mountains = this->shapes[ChunkColumn::Mountains];
+	mountains.base = 30.0;
+	mountains.ridged = true;
+	mountains.ridge = { 2.0, 128.0 };
+	mountains.ridgeExponent = 3.0;
+	mountains.erosion = { 8.0, 20.0, glm::dvec2(3829.0, -9438.0) };
+	mountains.ridgeMask = { 0.1, 1.0 };
+	mountains.layers = { { 12.0, 3.0 } };
+}
+
+void BiomeHeightmap::generate(const FastNoise* noise, const glm::ivec2& position, ChunkColumn& column) const {
+	for (uint16_t x = 0; x < ChunkColumn::WIDTH; x++) {
+		for (uint16_t z = 0; z < ChunkColumn::LENGTH; z++) {
+			int64_t globalX = x + static_cast<int64_t>(position.x) * ChunkColumn::WIDTH;
+			int64_t globalZ = z + static_cast<int64_t>(position.y) * ChunkColumn::LENGTH;
+
+			for (int biome = 0; biome < ChunkColumn::BiomeCount; biome++) {
+				column.biomeHeights[biome][x + z * ChunkColumn::WIDTH] = this->shapes[biome].sample(noise, static_cast<double>(globalX), static_cast<double>(globalZ));
+			}
+		}
+	}
+}
+
+void NoiseBiomeBlend::blend(const FastNoise* noise, const glm::ivec2& position, ChunkColumn& column) const {
+	for (uint16_t x = 0; x < ChunkColumn::WIDTH; x++) {
+		for (uint16_t z = 0; z < ChunkColumn::LENGTH; z++) {
+			double globalX = static_cast<double>(x + static_cast<int64_t>(position.x) * ChunkColumn::WIDTH);
+			double globalZ = static_cast<double>(z + static_cast<int64_t>(position.y) * ChunkColumn::LENGTH);
+
+			int height = glm::mix(column.getBiomeHeight(ChunkColumn::Hills, x, z), column.getBiomeHeight(ChunkColumn::Plains, x, z), this->plainsWeight.sample(noise, globalX, globalZ));
+			height = glm::mix(height, column.getBiomeHeight(ChunkColumn::Mountains, x, z), this->mountainsWeight.sample(noise, globalX, globalZ));
+
+			column.heights[x + z * ChunkColumn::WIDTH] = height + this->baseHeight;
+		}
+	}
+}
+
+void LayeredSurface::prepare(const FastNoise* noise, const glm::ivec2& position, ChunkColumn& column) const {
+	for (uint16_t x = 0; x < ChunkColumn::WIDTH; x++) {
+		for (uint16_t z = 0; z < ChunkColumn::LENGTH; z++) {
+			int64_t globalX = x + static_cast<int64_t>(position.x) * ChunkColumn::WIDTH;
+			int64_t globalZ = z + static_cast<int64_t>(position.y) * ChunkColumn::LENGTH;
+
+			column.surfaceNoise[x + z * ChunkColumn::WIDTH] = noise->GetWhiteNoiseInt(NoiseCoordinate::fold(globalX), NoiseCoordinate::fold(globalZ));
+		}
+	}
+}
+
+void CaveField::sample(const FastNoise* noise, std::vector<FN_DECIMAL>& density, const glm::i64vec3& origin, int width, int height, int length, uint16_t cellSize) {
+	density.resize(static_cast<size_t>(width) * height * length);
+	if (height <= 0) return;
+
+	FN_DECIMAL originX = NoiseCoordinate::wrap(noise, origin.x * 4.0, NoiseCoordinate::SIMPLEX_PERIOD);
+	FN_DECIMAL originY = NoiseCoordinate::wrap(noise, origin.y * 4.0, NoiseCoordinate::SIMPLEX_PERIOD);
+	FN_DECIMAL originZ = NoiseCoordinate::wrap(noise, origin.z * 4.0, NoiseCoordinate::SIMPLEX_PERIOD);
+
+	if (cellSize <= 1) {
+		noise->FillSimplexGrid(
+			density.data(),
+			originX, originY, originZ,
+			4.0f, 4.0f, 4.0f,
+			width, height, length
+		);
+		return;
+	}
+
+	int latticeWidth = (width + cellSize - 1) / cellSize + 1;
+	int latticeHeight = (height + cellSize - 1) / cellSize + 1;
+	int latticeLength = (length + cellSize - 1) / cellSize + 1;
+
+	std::vector<FN_DECIMAL> lattice(static_cast<size_t>(latticeWidth) * latticeHeight * latticeLength);
+	noise->FillSimplexGrid(
+		lattice.data(),
+		originX, originY, originZ,
+		cellSize * 4.0f, cellSize * 4.0f, cellSize * 4.0f,
+		latticeWidth, latticeHeight, latticeLength
+	);
+
+	// Separable trilinear interpolation: along x for every lattice row, then along y, then along z
+	std::vector<FN_DECIMAL> rows(static_cast<size_t>(width) * latticeHeight * latticeLength);
+	for (int lz = 0; lz < latticeLength; lz++) {
+		for (int ly = 0; ly < latticeHeight; ly++) {
+			const FN_DECIMAL* source = &lattice[(ly + lz * latticeHeight) * latticeWidth];
+			FN_DECIMAL* target = &rows[(ly + lz * latticeHeight) * width];
+
+			for (int x = 0; x < width; x++) {
+				target[x] = glm::mix(source[x / cellSize], source[x / cellSize + 1], static_cast<FN_DECIMAL>(x % cellSize) / cellSize);
+			}
+		}
+	}
+
+	std::vector<FN_DECIMAL> slices(static_cast<size_t>(width) * height * latticeLength);
+	for (int lz = 0; lz < latticeLength; lz++) {
+		for (int y = 0; y < height; y++) {
+			const FN_DECIMAL* below = &rows[(y / cellSize + lz * latticeHeight) * width];
+			const FN_DECIMAL* above = below + width;
+			FN_DECIMAL* target = &slices[(y + lz * height) * width];
+			FN_DECIMAL factor = static_cast<FN_DECIMAL>(y % cellSize) / cellSize;
+
+			for (int x = 0; x < width; x++) {
+				target[x] = glm::mix(below[x], above[x], factor);
+			}
+		}
+	}
+
+	for (int z = 0; z < length; z++) {
+		const FN_DECIMAL* back = &slices[(z / cellSize) * height * width];
+		const FN_DECIMAL* front = back + height * width;
+		FN_DECIMAL* target = &density[z * height * width];
+		FN_DECIMAL factor = static_cast<FN_DECIMAL>(z % cellSize) / cellSize;
+
+		for (int i = 0; i < height * width; i++) {
+			target[i] = glm::mix(back[i], front[i], factor);
+		}
+	}
+}
+
+void CaveCarver::carve(const FastNoise* noise, const glm::i64vec3& origin, int width, int height, int length, std::vector<uint8_t>& carved) const {
+	std::vector<FN_DECIMAL> density;
+	CaveField::sample(noise, density, origin, width, height, length, this->cellSize);
+
+	for (int z = 0; z < length; z++) {
+		for (int y = glm::max<int64_t>(0, this->minY - origin.y); y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				size_t index = x + (y + z * static_cast<size_t>(height)) * width;
+				if (density[index] <= this->threshold) carved[index] = 1;
+			}
+		}
+	}
+}
+
+TerrainGenerator::TerrainGenerator(const FastNoise* noise, uint16_t caveCellSize) :
+	noise(noise),
+	heightmap(std::make_unique<BiomeHeightmap>()),
+	biomeBlend(std::make_unique<NoiseBiomeBlend>()),
+	surface(std::make_unique<LayeredSurface>())
+{
+	this->carvers.push_back(std::make_unique<CaveCarver>(caveCellSize));
+}
+
+void TerrainGenerator::createColumn(const glm::ivec2& position, ChunkColumn& column) const {
+	column.timings = TerrainTimings();
+
+	column.timings.heightmap = TerrainTimings::measure([&]() { this->heightmap->generate(this->noise, position, column); });
+	column.timings.biomeBlend = TerrainTimings::measure([&]() { this->biomeBlend->blend(this->noise, position, column); });
+	column.timings.surface = TerrainTimings::measure([&]() { this->surface->prepare(this->noise, position, column); });
+}
+
+void TerrainGenerator::carve(const glm::i64vec3& origin, int width, int height, int length, std::vector<uint8_t>& carved) const {
+	carved.assign(static_cast<size_t>(width) * glm::max(height, 0) * length, 0);
+	if (height <= 0) return;
+
+	for (const std::unique_ptr<CarverStage>& carver : this->carvers) {
+		carver->carve(this->noise, origin, width, height, length, carved);
+	}
+}
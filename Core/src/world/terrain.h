@@ -0,0 +1,256 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "../noise/FastNoise.h"
+
+// FastNoise works in float, so absolute world coordinates lose precision far from the origin
+// Perlin noise repeats every 256 lattice cells and 3D simplex every 768 along each axis, so past one period the lattice part is wrapped
+// in double and only a small, still precise coordinate is handed to FastNoise (keeping its float SIMD path usable at any distance)
+// Coordinates within one period are passed through untouched, so terrain near the origin is exactly what plain floats produce
+struct NoiseCoordinate {
+	static constexpr double PERLIN_PERIOD = 256.0, SIMPLEX_PERIOD = 768.0;
+
+	static FN_DECIMAL wrap(const FastNoise* noise, double coordinate, double period) {
+		double frequency = noise->GetFrequency();
+		double lattice = coordinate * frequency;
+
+		if (fabs(lattice) < period) return static_cast<FN_DECIMAL>(coordinate);
+		return static_cast<FN_DECIMAL>((lattice - floor(lattice / period) * period) / frequency);
+	}
+	// Integer noise takes int coordinates, the times a block coordinate wrapped around 2 ^ 32 are hashed into it so it never repeats
+	// Coordinates that fit into an int are passed through untouched
+	static int fold(int64_t coordinate) {
+		int32_t low = static_cast<int32_t>(coordinate);
+		uint64_t wraps = (static_cast<uint64_t>(coordinate) - static_cast<uint64_t>(static_cast<int64_t>(low))) >> 32;
+
+		return low ^ static_cast<int32_t>(static_cast<uint32_t>(wraps * 0x9E3779B1u));
+	}
+};
+
+// Time spent in each terrain generation stage, in milliseconds
+struct TerrainTimings {
+	double heightmap = 0.0, biomeBlend = 0.0, surface = 0.0, carvers = 0.0;
+
+	template<typename Function>
+	static double measure(Function function) {
+		auto start = std::chrono::high_resolution_clock::now();
+		function();
+
+		return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	double total() const {
+		return this->heightmap + this->biomeBlend + this->surface + this->carvers;
+	}
+
+	TerrainTimings& operator+=(const TerrainTimings& other) {
+		this->heightmap += other.heightmap;
+		this->biomeBlend += other.biomeBlend;
+		this->surface += other.surface;
+		this->carvers += other.carvers;
+
+		return *this;
+	}
+	TerrainTimings operator/(double divisor) const {
+		TerrainTimings timings = *this;
+		timings.heightmap /= divisor;
+		timings.biomeBlend /= divisor;
+		timings.surface /= divisor;
+		timings.carvers /= divisor;
+
+		return timings;
+	}
+};
+
+// Everything the terrain needs that depends only on (x, z), shared by all vertical chunks of a column
+class ChunkColumn {
+public:
+	enum Biome { Hills, Plains, Mountains, BiomeCount };
+
+	static const uint16_t WIDTH = 32, LENGTH = 32;
+
+	// Written by the heightmap stage, one height per biome before blending
+	int biomeHeights[ChunkColumn::BiomeCount][ChunkColumn::WIDTH * ChunkColumn::LENGTH] = {};
+	// Written by the biome blend stage, world height of the terrain surface
+	int heights[ChunkColumn::WIDTH * ChunkColumn::LENGTH] = {};
+	// Written by the surface stage, per column variation of the surface layers
+	FN_DECIMAL surfaceNoise[ChunkColumn::WIDTH * ChunkColumn::LENGTH] = {};
+
+	// Time the column stages took for this column
+	TerrainTimings timings;
+
+	inline int getBiomeHeight(Biome biome, uint16_t x, uint16_t z) const {
+		return this->biomeHeights[biome][x + z * ChunkColumn::WIDTH];
+	}
+	inline int getHeight(uint16_t x, uint16_t z) const {
+		return this->heights[x + z * ChunkColumn::WIDTH];
+	}
+	inline FN_DECIMAL getSurfaceNoise(uint16_t x, uint16_t z) const {
+		return this->surfaceNoise[x + z * ChunkColumn::WIDTH];
+	}
+};
+
+// One octave of height noise, (perlin(x * frequency + offset) + 0.5) * amplitude
+struct NoiseLayer {
+	double frequency = 1.0, amplitude = 1.0;
+	glm::dvec2 offset = glm::dvec2();
+
+	inline double sample(const FastNoise* noise, double x, double z) const {
+		return (noise->GetPerlin(
+			NoiseCoordinate::wrap(noise, x * this->frequency + this->offset.x, NoiseCoordinate::PERLIN_PERIOD),
+			NoiseCoordinate::wrap(noise, z * this->frequency + this->offset.y, NoiseCoordinate::PERLIN_PERIOD)
+		) + 0.5) * this->amplitude;
+	}
+};
+
+// Height of one biome: base + optional ridged peaks + the sum of its layers
+struct BiomeShape {
+	double base = 0.0;
+	std::vector<NoiseLayer> layers;
+
+	// Peaks are (max(ridge, 0) ^ ridgeExponent * ridge.amplitude - erosion) * ridgeMask, the ridge noise itself is sampled with amplitude 1
+	bool ridged = false;
+	NoiseLayer ridge, erosion, ridgeMask;
+	double ridgeExponent = 1.0;
+
+	int sample(const FastNoise* noise, double x, double z) const;
+};
+
+// Terrain stages, each one can be replaced on a TerrainGenerator without touching Chunk
+class HeightmapStage {
+public:
+	virtual ~HeightmapStage() = default;
+	// Fills column.biomeHeights for the column at position (in chunks)
+	virtual void generate(const FastNoise* noise, const glm::ivec2& position, ChunkColumn& column) const = 0;
+};
+class BiomeBlendStage {
+public:
+	virtual ~BiomeBlendStage() = default;
+	// Fills column.heights from column.biomeHeights
+	virtual void blend(const FastNoise* noise, const glm::ivec2& position, ChunkColumn& column) const = 0;
+};
+class SurfaceStage {
+public:
+	virtual ~SurfaceStage() = default;
+	// Fills column.surfaceNoise, runs once per column
+	virtual void prepare(const FastNoise* noise, const glm::ivec2& position, ChunkColumn& column) const = 0;
+	// Block of a solid voxel at world height y, column->getHeight(x, z) is the first air voxel
+	virtual uint8_t getBlock(const ChunkColumn& column, uint16_t x, uint16_t z, int64_t y) const = 0;
+	// Block every voxel from minY to maxY (world heights, inclusive) of the column is made of, 0 when they differ
+	virtual uint8_t getUniformBlock(const ChunkColumn& column, uint16_t x, uint16_t z, int64_t minY, int64_t maxY) const = 0;
+};
+class CarverStage {
+public:
+	virtual ~CarverStage() = default;
+	// Sets carved[x + y * width + z * width * height] to 1 for every voxel of the box at origin (in blocks) this carver removes
+	// Other entries are left alone, so several carvers can share one buffer
+	virtual void carve(const FastNoise* noise, const glm::i64vec3& origin, int width, int height, int length, std::vector<uint8_t>& carved) const = 0;
+};
+
+class BiomeHeightmap : public HeightmapStage {
+public:
+	BiomeShape shapes[ChunkColumn::BiomeCount];
+
+	BiomeHeightmap();
+
+	void generate(const FastNoise* noise, const glm::ivec2& position, ChunkColumn& column) const override;
+};
+class NoiseBiomeBlend : public BiomeBlendStage {
+public:
+	// Hills fade into plains by plainsWeight, the result into mountains by mountainsWeight, then the surface is raised by baseHeight
+	NoiseLayer plainsWeight = { 0.05 };
+	NoiseLayer mountainsWeight = { 0.05, 1.0, glm::dvec2(3243.0, -3923.0) };
+	int baseHeight = 32;
+
+	void blend(const FastNoise* noise, const glm::ivec2& position, ChunkColumn& column) const override;
+};
+class LayeredSurface : public SurfaceStage {
+public:
+	// From the top: one top block, filler down to fillerDepth + surfaceNoise * fillerVariation below the surface, then stone
+	// The bottom layer of the world is bedrock
+	uint8_t top = 1, filler = 4, stone = 2, bedrock = 3;
+	int fillerDepth = 4;
+	float fillerVariation = 3.0f;
+
+	void prepare(const FastNoise* noise, const glm::ivec2& position, ChunkColumn& column) const override;
+	uint8_t getBlock(const ChunkColumn& column, uint16_t x, uint16_t z, int64_t y) const override {
+		int height = column.getHeight(x, z);
+
+		if (y == 0) return this->bedrock;
+		if (y == height - 1) return this->top;
+		if (this->isStone(column, x, z, y)) return this->stone;
+
+		return this->filler;
+	}
+	uint8_t getUniformBlock(const ChunkColumn& column, uint16_t x, uint16_t z, int64_t minY, int64_t maxY) const override {
+		return minY > 0 && this->isStone(column, x, z, maxY) ? this->stone : 0;
+	}
+private:
+	inline bool isStone(const ChunkColumn& column, uint16_t x, uint16_t z, int64_t y) const {
+		return y < column.getHeight(x, z) - this->fillerDepth - column.getSurfaceNoise(x, z) * this->fillerVariation;
+	}
+};
+
+class CaveField {
+public:
+	static constexpr double THRESHOLD = -0.49;
+
+	// Cave density for a box of voxels starting at origin, laid out as x + y * width + z * width * height
+	// cellSize 1 samples simplex noise at every voxel, larger powers of two sample a coarse lattice and interpolate trilinearly inside each cell
+	static void sample(const FastNoise* noise, std::vector<FN_DECIMAL>& density, const glm::i64vec3& origin, int width, int height, int length, uint16_t cellSize);
+};
+
+class CaveCarver : public CarverStage {
+public:
+	double threshold = CaveField::THRESHOLD;
+	uint16_t cellSize = 1;
+	// Caves never break through the bottom of the world
+	int64_t minY = 1;
+
+	CaveCarver(uint16_t cellSize = 1) : cellSize(cellSize) {}
+
+	void carve(const FastNoise* noise, const glm::i64vec3& origin, int width, int height, int length, std::vector<uint8_t>& carved) const override;
+};
+
+// Runs the terrain stages and owns them, replace any stage with the set* / addCarver methods
+class TerrainGenerator {
+private:
+	const FastNoise* noise = nullptr;
+
+	std::unique_ptr<HeightmapStage> heightmap;
+	std::unique_ptr<BiomeBlendStage> biomeBlend;
+	std::unique_ptr<SurfaceStage> surface;
+	std::vector<std::unique_ptr<CarverStage>> carvers;
+public:
+	// Starts with the built-in stages, caveCellSize is handed to the default cave carver
+	TerrainGenerator(const FastNoise* noise, uint16_t caveCellSize = 1);
+
+	void setHeightmap(std::unique_ptr<HeightmapStage> heightmap) {
+		this->heightmap = std::move(heightmap);
+	}
+	void setBiomeBlend(std::unique_ptr<BiomeBlendStage> biomeBlend) {
+		this->biomeBlend = std::move(biomeBlend);
+	}
+	void setSurface(std::unique_ptr<SurfaceStage> surface) {
+		this->surface = std::move(surface);
+	}
+	void addCarver(std::unique_ptr<CarverStage> carver) {
+		this->carvers.push_back(std::move(carver));
+	}
+	void clearCarvers() {
+		this->carvers.clear();
+	}
+
+	// Heightmap, biome blend and the per column part of the surface stage, timed into column.timings
+	void createColumn(const glm::ivec2& position, ChunkColumn& column) const;
+	// Runs every carver over the box, carved is laid out as x + y * width + z * width * height
+	void carve(const glm::i64vec3& origin, int width, int height, int length, std::vector<uint8_t>& carved) const;
+
+	const SurfaceStage* getSurface() const {
+		return this->surface.get();
+	}
+};
@@ -0,0 +1,51 @@
+#include "worldhashes.h"
+
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "generator.h"
+
+bool WorldHashes::save(const char* path, int seed) {
+	std::unique_ptr<ChunkGenerator> chunkGenerator = std::make_unique<ChunkGenerator>(seed);
+	chunkGenerator->create();
+
+	std::ofstream file(path);
+	if (!file) return false;
+
+	file << "seed " << seed << "\n";
+	for (size_t x = 0; x < ChunkGenerator::CHUNKS_X; x++) {
+		for (size_t y = 0; y < ChunkGenerator::CHUNKS_Y; y++) {
+			for (size_t z = 0; z < ChunkGenerator::CHUNKS_Z; z++) {
+				file << x << " " << y << " " << z << " " << std::hex << chunkGenerator->chunks[INDEX_FROM_XYZ(x, y, z, ChunkGenerator::CHUNKS_X, ChunkGenerator::CHUNKS_Z)].hash() << std::dec << "\n";
+			}
+		}
+	}
+
+	return static_cast<bool>(file);
+}
+
+bool WorldHashes::verify(const char* path, Report& report) {
+	std::ifstream file(path);
+	std::string keyword;
+
+	report = Report();
+	if (!(file >> keyword >> report.seed) || keyword != "seed") return false;
+
+	std::unique_ptr<ChunkGenerator> chunkGenerator = std::make_unique<ChunkGenerator>(report.seed);
+	chunkGenerator->create();
+
+	size_t x, y, z;
+	uint64_t expected;
+
+	while (file >> x >> y >> z >> std::hex >> expected >> std::dec) {
+		if (x >= ChunkGenerator::CHUNKS_X || y >= ChunkGenerator::CHUNKS_Y || z >= ChunkGenerator::CHUNKS_Z) continue;
+
+		uint64_t actual = chunkGenerator->chunks[INDEX_FROM_XYZ(x, y, z, ChunkGenerator::CHUNKS_X, ChunkGenerator::CHUNKS_Z)].hash();
+		if (actual != expected) report.mismatches.push_back({ .position = glm::ivec3(x, y, z), .expected = expected, .actual = actual });
+
+		report.checked++;
+	}
+
+	return report.checked > 0;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// Per chunk content hashes of a generated world, saved once and verified after every generator change
+// The file starts with "seed <seed>", followed by one "<x> <y> <z> <hash>" line per chunk
+struct WorldHashes {
+	static const int DEFAULT_SEED = 1337;
+
+	struct Mismatch {
+		glm::ivec3 position;
+		uint64_t expected, actual;
+	};
+	struct Report {
+		int seed = 0;
+		size_t checked = 0;
+		std::vector<Mismatch> mismatches;
+	};
+
+	// Generates the world of seed and writes the hash of every chunk to path, false when it cannot be written
+	static bool save(const char* path, int seed);
+	// Generates the world of the seed in path again and compares every chunk it lists
+	// False when path is no hash file or lists no chunk, chunks that differ end up in report.mismatches
+	static bool verify(const char* path, Report& report);
+};
@@ -1,11 +1,11 @@
 #include <Brainstorm/brainstorm.h>
 #include <glm/gtc/matrix_transform.hpp>
-#include "FastNoise.h"
+#include <core.h>
 
 #include <thread>
-#include <mutex>
-
-#define INDEX_FROM_XYZ(X, Y, Z, WIDTH, LENGTH) ((X) + (Z) * (WIDTH) + (Y) * (WIDTH) * (LENGTH))
+#include <memory>
+#include <cstring>
+#include <random>
 
 struct MatrixHelper {
 	static glm::mat4 perspective(const BS::Window* window, float fov) {
@@ -36,7 +36,6 @@ class BlockTextureAtlas {
 private:
 public:
 	const GLuint id = 0;
-	static const float SCALAR_X, SCALAR_Y;
 	
 	BlockTextureAtlas() {}
 	BlockTextureAtlas(GLuint id) : id(id) {}
@@ -45,545 +44,179 @@ public:
 		return BlockTextureAtlas(BS::Texture::loadFromFile("assets/textures/terrain.png", BS::Texture::FILTER_NEAREST));
 	}
 };
-struct BlockFace {
-	glm::vec2 uv = glm::vec2(); // "NULL" texture
-
-	BlockFace() {}
-	BlockFace(glm::ivec2 uv) : uv(glm::vec2(uv.x * BlockTextureAtlas::SCALAR_X, uv.y * BlockTextureAtlas::SCALAR_Y)) {}
-};
-
-const float BlockTextureAtlas::SCALAR_X = 16.0f / 256.0f;
-const float BlockTextureAtlas::SCALAR_Y = 16.0f / 256.0f;
-
-struct Block {
-	BlockFace front = {};
-	BlockFace back = {};
-	BlockFace top = {};
-	BlockFace bottom = {};
-	BlockFace right = {};
-	BlockFace left = {};
-
-	static inline Block create(const BlockFace all) {
-		return {
-			.front = all,
-			.back = all,
-			.top = all,
-			.bottom = all,
-			.right = all,
-			.left = all
-		};
-	}
-	static inline Block create(const BlockFace side, const BlockFace top, const BlockFace bottom) {
-		return {
-			.front = side,
-			.back = side,
-			.top = top,
-			.bottom = bottom,
-			.right = side,
-			.left = side
-		};
-	}
-	static inline Block create(const BlockFace horizontal, const BlockFace vertical) {
-		return {
-			.front = horizontal,
-			.back = horizontal,
-			.top = vertical,
-			.bottom = vertical,
-			.right = horizontal,
-			.left = horizontal
-		};
-	}
-};
-class Blocks {
+// One vertex buffer and vertex array for the whole terrain, every chunk mesh is a range of it handed out by a VertexArena
+// Remeshing rewrites a range with glBufferSubData instead of creating and deleting GL objects per chunk
+class TerrainBuffer {
 private:
-	static std::vector<Block> blocks;
-public:
-	static void registerEntry(const Block block) {
-		Blocks::blocks.push_back(block);
-	}
-	static const Block* getEntry(uint8_t id) {
-		id--;
+	GLuint id = 0, vboId = 0, indexBufferId = 0;
+	VertexArena arena;
 
-		if (id < 0 || id >= Blocks::blocks.size()) {
-			return nullptr;
-		}
+	// Per draw chunk origins (an instanced attribute) and the indirect commands, rewritten every frame
+	GLuint originVboId = 0, commandBufferId = 0;
+	// glMultiDrawElementsIndirect with baseInstance needs GL 4.3 (or its two extensions), without it every command is drawn on its own
+	bool multiDrawIndirect = false;
 
-		return &Blocks::blocks[id];
-	}
-};
+	// Replaces the buffer with one of capacity vertices: the old contents are copied over as they are, then moves are applied on top
+	void relocate(uint32_t capacity, uint32_t keep, const std::vector<VertexArena::Move>& moves) {
+		GLuint vboId;
 
-std::vector<Block> Blocks::blocks = {};
+		glGenBuffers(1, &vboId);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, vboId);
+		glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(capacity) * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_COPY_READ_BUFFER, this->vboId);
 
-class Chunk {
-private:
-	uint8_t* blocks = nullptr;
-	glm::ivec3 position = glm::ivec3();
-
-	const FastNoise* noise = nullptr;
-
-	inline double getPerlin(double x, double z) const {
-		return this->noise->GetPerlin(x, z) + 0.5;
-	}
-	inline int getHillsHeight(int64_t x, int64_t z) const {
-		return static_cast<int>(
-			this->getPerlin(x, z) * 48.0 +
-			this->getPerlin(x * 5.0, z * 5.0) * 12.0 +
-			this->getPerlin(x * 0.1, z * 0.1) * 32.0
-		);
-	}
-	inline int getPlainsHeight(int64_t x, int64_t z) const {
-		return static_cast<int>(
-			20.0 +
-			getPerlin(x * 0.4, z * 0.4) * 3.0 +
-			getPerlin(x * 0.1, z * 0.1) * 12.0
-		);
-	}
-	inline int getMountainsHeight(int64_t x, int64_t z) const {
-		return static_cast<int>(
-			30.0f +
-			(pow(glm::max(getPerlin(x * 2.0, z * 2.0), 0.0), 3.0) * 128.0 - getPerlin(x * 8.0 + 3829.0, z * 8.0 - 9438.0) * 20.0) * getPerlin(x * 0.1, z * 0.1) +
-			getPerlin(x * 12.0, z * 12.0) * 3.0
-		);
-	}
-public:
-	static const uint16_t WIDTH = 32, HEIGHT = 32, LENGTH = 32;
-
-	~Chunk() {
-		delete[] this->blocks;
-	}
-
-	void setGenerator(const FastNoise* noise) {
-		this->noise = noise;
-	}
-	void create(const glm::ivec3& position, size_t chunksY) {
-		if (this->blocks != nullptr || this->noise == nullptr) return;
-
-		this->position = position;
-		this->blocks = new uint8_t[Chunk::WIDTH * Chunk::HEIGHT * Chunk::LENGTH]();
-
-		if (this->position.y == 0) {
-			for (uint16_t x = 0; x < Chunk::WIDTH; x++) {
-				for (uint16_t z = 0; z < Chunk::LENGTH; z++) {
-					this->setBlock(x, 0, z, 3);
-				}
-			}
+		if (keep > 0) glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>(keep) * sizeof(uint32_t));
+		for (const VertexArena::Move& move : moves) {
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, move.from * sizeof(uint32_t), move.to * sizeof(uint32_t), move.size * sizeof(uint32_t));
 		}
 
-		for (uint16_t x = 0; x < Chunk::WIDTH; x++) {
-			for (uint16_t z = 0; z < Chunk::LENGTH; z++) {
-				int64_t globalX = x + static_cast<int64_t>(this->position.x) * Chunk::WIDTH;
-				int64_t globalZ = z + static_cast<int64_t>(this->position.z) * Chunk::LENGTH;
-
-				int height = glm::mix(this->getHillsHeight(globalX, globalZ), this->getPlainsHeight(globalX, globalZ), this->getPerlin(globalX * 0.05, globalZ * 0.05));
-				height = glm::mix(height, this->getMountainsHeight(globalX, globalZ), this->getPerlin(globalX * 0.05 + 3243.0, globalZ * 0.05 - 3923.0));
-				height += 32;
-				height -= this->position.y * Chunk::HEIGHT;
-				
-				int clampedHeight = glm::clamp<int>(height, 0, Chunk::HEIGHT);
-
-				for (uint16_t y = this->position.y == 0 ? 1 : 0; y < clampedHeight; y++) {
-					if (this->noise->GetSimplex(globalX * 4.0, (this->position.y * Chunk::HEIGHT + y) * 4.0, globalZ * 4.0) <= -0.49) continue;
-
-					uint8_t block = 4;
-					
-					if (clampedHeight == height && y == clampedHeight - 1) block = 1;
-					else if (y < height - 4 - this->noise->GetWhiteNoise(globalX, globalZ) * 3.0f) block = 2;
-
-					this->setBlock(x, y, z, block);
-				}
-			}
-		}
+		glDeleteBuffers(1, &this->vboId);
+		this->vboId = vboId;
+		this->bind();
 	}
+	// Leaves the vertex array bound, relocating happens in the middle of drawing
+	void bind() const {
+		glBindVertexArray(this->id);
+		glBindBuffer(GL_ARRAY_BUFFER, this->vboId);
 
-	void setBlock(uint16_t x, uint16_t y, uint16_t z, uint8_t block) {
-		if (this->blocks == nullptr || x >= Chunk::WIDTH || y >= Chunk::HEIGHT || z >= Chunk::LENGTH) return;
-		this->blocks[INDEX_FROM_XYZ(x, y, z, Chunk::WIDTH, Chunk::LENGTH)] = block;
-	}
-	uint8_t getBlock(uint16_t x, uint16_t y, uint16_t z) const {
-		if (this->blocks == nullptr || x >= Chunk::WIDTH || y >= Chunk::HEIGHT || z >= Chunk::LENGTH) return 0;
-		return this->blocks[INDEX_FROM_XYZ(x, y, z, Chunk::WIDTH, Chunk::LENGTH)];
-	}
+		// One packed ChunkVertex per vertex, read as an integer attribute and decoded by the shader
+		glEnableVertexAttribArray(0);
+		glVertexAttribIPointer(0, 1, GL_UNSIGNED_INT, 0, nullptr);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->indexBufferId);
 
-	glm::ivec3 getPosition() const {
-		return this->position;
+		// One chunk origin per instance, the baseInstance of a command picks its chunk
+		glBindBuffer(GL_ARRAY_BUFFER, this->originVboId);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+		glVertexAttribDivisor(1, 1);
 	}
-};
-class ChunkMesh {
-private:
-	GLuint id = 0, vboId = 0, tboId = 0, nboId = 0, aboId = 0;
-	GLsizei vertexCount = 0;
-
-	const Chunk* chunk = nullptr;
-	bool dirty = false, gpuDirty = false;
+public:
+	// capacity in vertices, the buffer grows when it runs out, indexBufferId comes from createIndexBuffer()
+	TerrainBuffer(uint32_t capacity, GLuint indexBufferId) : indexBufferId(indexBufferId), arena(capacity) {
+		this->multiDrawIndirect = GLEW_VERSION_4_3 || (GLEW_ARB_multi_draw_indirect && GLEW_ARB_base_instance);
 
-	std::vector<float> vertices, texcoords, normals, ambients;
+		glGenVertexArrays(1, &this->id);
+		glGenBuffers(1, &this->vboId);
+		glGenBuffers(1, &this->originVboId);
+		glGenBuffers(1, &this->commandBufferId);
 
-	inline void addNormals(float x, float y, float z) {
-		this->normals.push_back(x); this->normals.push_back(y); this->normals.push_back(z);
-		this->normals.push_back(x); this->normals.push_back(y); this->normals.push_back(z);
-		this->normals.push_back(x); this->normals.push_back(y); this->normals.push_back(z);
+		glBindBuffer(GL_ARRAY_BUFFER, this->vboId);
+		glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(this->arena.getCapacity()) * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
 
-		this->normals.push_back(x); this->normals.push_back(y); this->normals.push_back(z);
-		this->normals.push_back(x); this->normals.push_back(y); this->normals.push_back(z);
-		this->normals.push_back(x); this->normals.push_back(y); this->normals.push_back(z);
-	}
-	inline void addTexcoords(BlockFace face) {
-		this->texcoords.push_back(face.uv.x);								this->texcoords.push_back(face.uv.y);
-		this->texcoords.push_back(face.uv.x + BlockTextureAtlas::SCALAR_X); this->texcoords.push_back(face.uv.y);
-		this->texcoords.push_back(face.uv.x);								this->texcoords.push_back(face.uv.y + BlockTextureAtlas::SCALAR_Y);
-
-		this->texcoords.push_back(face.uv.x + BlockTextureAtlas::SCALAR_X); this->texcoords.push_back(face.uv.y + BlockTextureAtlas::SCALAR_Y);
-		this->texcoords.push_back(face.uv.x);								this->texcoords.push_back(face.uv.y + BlockTextureAtlas::SCALAR_Y);
-		this->texcoords.push_back(face.uv.x + BlockTextureAtlas::SCALAR_X); this->texcoords.push_back(face.uv.y);
+		this->bind();
+		BS::Mesh::drop();
 	}
-	inline void addAmbients(uint8_t top, uint8_t right, uint8_t left, uint8_t bottom, uint8_t topRight, uint8_t topLeft, uint8_t bottomRight, uint8_t bottomLeft) {
-		float a00 = ChunkMesh::buildAmbient(left, bottom, bottomLeft);
-		float a10 = ChunkMesh::buildAmbient(right, bottom, bottomRight);
-		float a11 = ChunkMesh::buildAmbient(right, top, topRight);
-		float a01 = ChunkMesh::buildAmbient(left, top, topLeft);
-
-		this->ambients.push_back(a10);
-		this->ambients.push_back(a00);
-		this->ambients.push_back(a11);
-		this->ambients.push_back(a01);
-		this->ambients.push_back(a11);
-		this->ambients.push_back(a00);
+	~TerrainBuffer() {
+		glDeleteVertexArrays(1, &this->id);
+		glDeleteBuffers(1, &this->vboId);
+		glDeleteBuffers(1, &this->originVboId);
+		glDeleteBuffers(1, &this->commandBufferId);
 	}
 
-	static inline GLuint createVbo(const std::vector<float>& buffer, GLuint attributeIndex, GLint attributeDimensions) {
+	// QUAD_INDICES for the biggest possible chunk mesh, shared by every chunk
+	static GLuint createIndexBuffer() {
+		std::vector<uint32_t> indices = ChunkMeshData::createIndices(ChunkMesh::MAX_QUADS);
 		GLuint id;
 
 		glGenBuffers(1, &id);
-		glBindBuffer(GL_ARRAY_BUFFER, id);
-
-		glBufferData(GL_ARRAY_BUFFER, buffer.size() * sizeof(float), buffer.data(), GL_STATIC_DRAW);
-
-		glEnableVertexAttribArray(attributeIndex);
-		glVertexAttribPointer(attributeIndex, attributeDimensions, GL_FLOAT, false, 0, nullptr);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, id);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
 
 		return id;
 	}
-	static inline float buildAmbient(const uint8_t a, const uint8_t b, const uint8_t c) {
-		return (a == 0 ? 0.0f : 1.0f) + (b == 0 ? 0.0f : 1.0f) + (c == 0 ? 0.0f : 1.0f);
-	}
 
-	inline void create(const Chunk* rightChunk, const Chunk* leftChunk, const Chunk* frontChunk, const Chunk* backChunk, const Chunk* topChunk, const Chunk* bottomChunk) {
-		if (this->chunk == nullptr) return;
-
-		for (uint16_t x0 = 0; x0 < Chunk::WIDTH; x0++) {
-			for (uint16_t y0 = 0; y0 < Chunk::HEIGHT; y0++) {
-				for (uint16_t z0 = 0; z0 < Chunk::LENGTH; z0++) {
-					uint8_t id = this->chunk->getBlock(x0, y0, z0);
-					if (id == 0) continue;
-
-					uint16_t x1 = x0 + 1;
-					uint16_t y1 = y0 + 1;
-					uint16_t z1 = z0 + 1;
-
-					const Block* block = Blocks::getEntry(id);
-
-					if (y0 == Chunk::HEIGHT - 1 ? topChunk == nullptr || topChunk->getBlock(x0, 0, z0) == 0 : this->chunk->getBlock(x0, y0 + 1, z0) == 0) {
-						this->vertices.push_back(x0);		this->vertices.push_back(y0 + 1); this->vertices.push_back(z0 + 1);
-						this->vertices.push_back(x0 + 1); this->vertices.push_back(y0 + 1); this->vertices.push_back(z0 + 1);
-						this->vertices.push_back(x0);		this->vertices.push_back(y0 + 1); this->vertices.push_back(z0);
-
-						this->vertices.push_back(x0 + 1); this->vertices.push_back(y0 + 1); this->vertices.push_back(z0);
-						this->vertices.push_back(x0);		this->vertices.push_back(y0 + 1); this->vertices.push_back(z0);
-						this->vertices.push_back(x0 + 1); this->vertices.push_back(y0 + 1); this->vertices.push_back(z0 + 1);
-
-						this->addTexcoords(block->top);
-						this->addNormals(0.0f, 1.0f, 0.0f);
-
-						uint8_t top = this->chunk->getBlock(x0, y1, z0 - 1);
-						uint8_t right = this->chunk->getBlock(x0 - 1, y1, z0);
-						uint8_t left = this->chunk->getBlock(x1, y1, z0);
-						uint8_t bottom = this->chunk->getBlock(x0, y1, z1);
-						uint8_t topRight = this->chunk->getBlock(x0 - 1, y1, z0 - 1);
-						uint8_t topLeft = this->chunk->getBlock(x1, y1, z0 - 1);
-						uint8_t bottomRight = this->chunk->getBlock(x0 - 1, y1, z1);
-						uint8_t bottomLeft = this->chunk->getBlock(x1, y1, z1);
-
-						this->addAmbients(top, right, left, bottom, topRight, topLeft, bottomRight, bottomLeft);
-					}
-					if (y0 == 0 ? bottomChunk == nullptr || bottomChunk->getBlock(x0, Chunk::HEIGHT - 1, z0) == 0 : this->chunk->getBlock(x0, y0 - 1, z0) == 0) {
-						this->vertices.push_back(x0);		 this->vertices.push_back(y0); this->vertices.push_back(z0);
-						this->vertices.push_back(x0 + 1); this->vertices.push_back(y0); this->vertices.push_back(z0);
-						this->vertices.push_back(x0);		 this->vertices.push_back(y0); this->vertices.push_back(z0 + 1);
-
-						this->vertices.push_back(x0 + 1); this->vertices.push_back(y0); this->vertices.push_back(z0 + 1);
-						this->vertices.push_back(x0);		 this->vertices.push_back(y0); this->vertices.push_back(z0 + 1);
-						this->vertices.push_back(x0 + 1); this->vertices.push_back(y0); this->vertices.push_back(z0);
-
-						this->addTexcoords(block->bottom);
-						this->addNormals(0.0f, -1.0f, 0.0f);
-
-						uint8_t top = this->chunk->getBlock(x0, y0 - 1, z1);
-						uint8_t right = this->chunk->getBlock(x0 - 1, y0 - 1, z0);
-						uint8_t left = this->chunk->getBlock(x1, y0 - 1, z0);
-						uint8_t bottom = this->chunk->getBlock(x0, y0 - 1, z0 - 1);
-						uint8_t topRight = this->chunk->getBlock(x0 - 1, y0 - 1, z1);
-						uint8_t topLeft = this->chunk->getBlock(x1, y0 - 1, z1);
-						uint8_t bottomRight = this->chunk->getBlock(x0 - 1, y0 - 1, z0 - 1);
-						uint8_t bottomLeft = this->chunk->getBlock(x1, y0 - 1, z0 - 1);
-
-						this->addAmbients(top, right, left, bottom, topRight, topLeft, bottomRight, bottomLeft);
-					}
-					if (x0 == Chunk::WIDTH - 1 ? rightChunk == nullptr || rightChunk->getBlock(0, y0, z0) == 0 : this->chunk->getBlock(x0 + 1, y0, z0) == 0) {
-						this->vertices.push_back(x0 + 1); this->vertices.push_back(y0);		  this->vertices.push_back(z0 + 1);
-						this->vertices.push_back(x0 + 1); this->vertices.push_back(y0);		  this->vertices.push_back(z0);
-						this->vertices.push_back(x0 + 1); this->vertices.push_back(y0 + 1); this->vertices.push_back(z0 + 1);
-
-						this->vertices.push_back(x0 + 1); this->vertices.push_back(y0 + 1); this->vertices.push_back(z0);
-						this->vertices.push_back(x0 + 1); this->vertices.push_back(y0 + 1); this->vertices.push_back(z0 + 1);
-						this->vertices.push_back(x0 + 1); this->vertices.push_back(y0);		  this->vertices.push_back(z0);
-
-						this->addTexcoords(block->right);
-						this->addNormals(1.0f, 0.0f, 0.0f);
-
-						uint8_t top = this->chunk->getBlock(x1, y1, z0);
-						uint8_t right = this->chunk->getBlock(x1, y0, z1);
-						uint8_t left = this->chunk->getBlock(x1, y0, z0 - 1);
-						uint8_t bottom = this->chunk->getBlock(x1, y0 - 1, z0);
-						uint8_t topRight = this->chunk->getBlock(x1, y1, z1);
-						uint8_t topLeft = this->chunk->getBlock(x1, y1, z0 - 1);
-						uint8_t bottomRight = this->chunk->getBlock(x1, y0 - 1, z1);
-						uint8_t bottomLeft = this->chunk->getBlock(x1, y0 - 1, z0 - 1);
-
-						this->addAmbients(top, right, left, bottom, topRight, topLeft, bottomRight, bottomLeft);
-					}
-					if (x0 == 0 ? leftChunk == nullptr || leftChunk->getBlock(Chunk::WIDTH - 1, y0, z0) == 0 : this->chunk->getBlock(x0 - 1, y0, z0) == 0) {
-						this->vertices.push_back(x0); this->vertices.push_back(y0);		   this->vertices.push_back(z0);
-						this->vertices.push_back(x0); this->vertices.push_back(y0);		   this->vertices.push_back(z0 + 1);
-						this->vertices.push_back(x0); this->vertices.push_back(y0 + 1); this->vertices.push_back(z0);
-
-						this->vertices.push_back(x0); this->vertices.push_back(y0 + 1); this->vertices.push_back(z0 + 1);
-						this->vertices.push_back(x0); this->vertices.push_back(y0 + 1); this->vertices.push_back(z0);
-						this->vertices.push_back(x0); this->vertices.push_back(y0);		   this->vertices.push_back(z0 + 1);
-
-						this->addTexcoords(block->left);
-						this->addNormals(-1.0f, 0.0f, 0.0f);
-
-						uint8_t top = this->chunk->getBlock(x0 - 1, y1, z0);
-						uint8_t right = this->chunk->getBlock(x0 - 1, y0, z0 - 1);
-						uint8_t left = this->chunk->getBlock(x0 - 1, y0, z1);
-						uint8_t bottom = this->chunk->getBlock(x0 - 1, y0 - 1, z0);
-						uint8_t topRight = this->chunk->getBlock(x0 - 1, y1, z0 - 1);
-						uint8_t topLeft = this->chunk->getBlock(x0 - 1, y1, z1);
-						uint8_t bottomRight = this->chunk->getBlock(x0 - 1, y0 - 1, z0 - 1);
-						uint8_t bottomLeft = this->chunk->getBlock(x0 - 1, y0 - 1, z1);
-
-						this->addAmbients(top, right, left, bottom, topRight, topLeft, bottomRight, bottomLeft);
-					}
-					if (z0 == Chunk::LENGTH - 1 ? frontChunk == nullptr || frontChunk->getBlock(x0, y0, 0) == 0 : this->chunk->getBlock(x0, y0, z0 + 1) == 0) {
-						this->vertices.push_back(x0);		 this->vertices.push_back(y0);		  this->vertices.push_back(z0 + 1);
-						this->vertices.push_back(x0 + 1); this->vertices.push_back(y0);		  this->vertices.push_back(z0 + 1);
-						this->vertices.push_back(x0);		 this->vertices.push_back(y0 + 1); this->vertices.push_back(z0 + 1);
-
-						this->vertices.push_back(x0 + 1); this->vertices.push_back(y0 + 1); this->vertices.push_back(z0 + 1);
-						this->vertices.push_back(x0);		 this->vertices.push_back(y0 + 1); this->vertices.push_back(z0 + 1);
-						this->vertices.push_back(x0 + 1); this->vertices.push_back(y0);		  this->vertices.push_back(z0 + 1);
-
-						this->addTexcoords(block->front);
-						this->addNormals(0.0f, 0.0f, 1.0f);
-
-						uint8_t top = this->chunk->getBlock(x0, y1, z1);
-						uint8_t right = this->chunk->getBlock(x0 - 1, y0, z1);
-						uint8_t left = this->chunk->getBlock(x1, y0, z1);
-						uint8_t bottom = this->chunk->getBlock(x0, y0 - 1, z1);
-						uint8_t topRight = this->chunk->getBlock(x0 - 1, y1, z1);
-						uint8_t topLeft = this->chunk->getBlock(x1, y1, z1);
-						uint8_t bottomRight = this->chunk->getBlock(x0 - 1, y0 - 1, z1);
-						uint8_t bottomLeft = this->chunk->getBlock(x1, y0 - 1, z1);
-
-						this->addAmbients(top, right, left, bottom, topRight, topLeft, bottomRight, bottomLeft);
-					}
-					if (z0 == 0 ? backChunk == nullptr || backChunk->getBlock(x0, y0, Chunk::LENGTH - 1) == 0 : this->chunk->getBlock(x0, y0, z0 - 1) == 0) {
-						this->vertices.push_back(x0 + 1); this->vertices.push_back(y0);		  this->vertices.push_back(z0);
-						this->vertices.push_back(x0);		 this->vertices.push_back(y0);		  this->vertices.push_back(z0);
-						this->vertices.push_back(x0 + 1); this->vertices.push_back(y0 + 1); this->vertices.push_back(z0);
-
-						this->vertices.push_back(x0);		 this->vertices.push_back(y0 + 1); this->vertices.push_back(z0);
-						this->vertices.push_back(x0 + 1); this->vertices.push_back(y0 + 1); this->vertices.push_back(z0);
-						this->vertices.push_back(x0);		 this->vertices.push_back(y0);		  this->vertices.push_back(z0);
-
-						this->addTexcoords(block->back);
-						this->addNormals(0.0f, 0.0f, 1.0f);
-
-						uint8_t top = this->chunk->getBlock(x0, y1, z0 - 1);
-						uint8_t right = this->chunk->getBlock(x1, y0, z0 - 1);
-						uint8_t left = this->chunk->getBlock(x0 - 1, y0, z0 - 1);
-						uint8_t bottom = this->chunk->getBlock(x0, y0 - 1, z0 - 1);
-						uint8_t topRight = this->chunk->getBlock(x1, y1, z0 - 1);
-						uint8_t topLeft = this->chunk->getBlock(x0 - 1, y1, z0 - 1);
-						uint8_t bottomRight = this->chunk->getBlock(x1, y0 - 1, z0 - 1);
-						uint8_t bottomLeft = this->chunk->getBlock(x0 - 1, y0 - 1, z0 - 1);
-
-						this->addAmbients(top, right, left, bottom, topRight, topLeft, bottomRight, bottomLeft);
-					}
-				}
+	// Copies vertices into a new range and returns its arena id, VertexArena::INVALID for no vertices
+	uint32_t upload(const std::vector<uint32_t>& vertices) {
+		if (vertices.empty()) return VertexArena::INVALID;
+		uint32_t size = static_cast<uint32_t>(vertices.size());
+
+		uint32_t allocation = this->arena.allocate(size);
+		if (allocation == VertexArena::INVALID) {
+			// Enough space in pieces: pack the ranges together, else grow to twice the size
+			if (this->arena.getFree() >= size + VertexArena::PAGE_SIZE) {
+				// Allocations already in place get no move, so the whole old buffer is kept under the moves
+				this->relocate(this->arena.getCapacity(), this->arena.getCapacity(), this->arena.defragment());
+
+				BS::Logger::info("Terrain buffer defragmented");
 			}
-		}
+			else {
+				uint32_t capacity = this->arena.getCapacity();
+				this->arena.grow(std::max(capacity * 2, capacity + size));
+				this->relocate(this->arena.getCapacity(), capacity, {});
 
-		this->vertexCount = static_cast<GLsizei>(vertices.size() / 3);
-		this->gpuDirty = true;
-	}
+				BS::Logger::info("Terrain buffer grown to %u vertices", this->arena.getCapacity());
+			}
 
-	inline void clear() const {
-		glDeleteVertexArrays(1, &this->id);
+			allocation = this->arena.allocate(size);
+		}
 
-		glDeleteBuffers(1, &this->vboId);
-		glDeleteBuffers(1, &this->tboId);
-		glDeleteBuffers(1, &this->nboId);
-		glDeleteBuffers(1, &this->aboId);
-	}
-public:
-	ChunkMesh() {}
-	~ChunkMesh() {
-		this->clear();
-	}
+		glBindBuffer(GL_ARRAY_BUFFER, this->vboId);
+		glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(this->arena.getOffset(allocation)) * sizeof(uint32_t), size * sizeof(uint32_t), vertices.data());
 
-	void connect(const Chunk* chunk) {
-		this->chunk = chunk;
+		return allocation;
+	}
+	void free(uint32_t allocation) {
+		if (allocation != VertexArena::INVALID) this->arena.free(allocation);
 	}
 
 	void use() const {
 		glBindVertexArray(this->id);
 	}
-	void render(const BS::ShaderProgram shader, const BlockTextureAtlas blockTextureAtlas, const glm::mat4& projectViewMatrix) const {
-		BS::Texture::use(blockTextureAtlas.id);
-		glm::mat4 modelMatrix = MatrixHelper::transform(this->chunk->getPosition() * glm::ivec3(Chunk::WIDTH, Chunk::HEIGHT, Chunk::LENGTH), glm::vec3(), glm::vec3(1.0f));
-
-		shader.setMatrix4("mvpMatrix", projectViewMatrix * modelMatrix);
-		shader.setMatrix4("modelMatrix", modelMatrix);
-		
-		glDrawArrays(GL_TRIANGLES, 0, this->vertexCount);
-	}
-	void update(const Chunk* rightChunk = nullptr, const Chunk* leftChunk = nullptr, const Chunk* frontChunk = nullptr, const Chunk* backChunk = nullptr, const Chunk* topChunk = nullptr, const Chunk* bottomChunk = nullptr) {
-		if (!this->dirty) return;
-
-		this->create(rightChunk, leftChunk, frontChunk, backChunk, topChunk, bottomChunk);
-		this->dirty = false;
+	const VertexArena& getArena() const {
+		return this->arena;
 	}
-	void saveToGPU() {
-		if (!this->gpuDirty) return;
-		this->clear();
 
-		glGenVertexArrays(1, &this->id);
-		this->use();
+	// Draws every command of commands with one glMultiDrawElementsIndirect, has to be in use
+	void draw(const DrawCommandList& commands) {
+		if (commands.size() == 0) return;
+		const std::vector<glm::vec3>& origins = commands.getOrigins();
 
-		this->vboId = ChunkMesh::createVbo(this->vertices, 0, 3);
-		this->tboId = ChunkMesh::createVbo(this->texcoords, 1, 2);
-		this->nboId = ChunkMesh::createVbo(this->normals, 2, 3);
-		this->aboId = ChunkMesh::createVbo(this->ambients, 3, 1);
-
-		BS::Mesh::drop();
+		if (this->multiDrawIndirect) {
+			glBindBuffer(GL_ARRAY_BUFFER, this->originVboId);
+			glBufferData(GL_ARRAY_BUFFER, origins.size() * sizeof(glm::vec3), origins.data(), GL_STREAM_DRAW);
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, this->commandBufferId);
+			glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand), commands.getCommands().data(), GL_STREAM_DRAW);
 
-		this->vertices.clear();
-		this->vertices.shrink_to_fit();
+			glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(commands.size()), 0);
 
-		this->texcoords.clear();
-		this->texcoords.shrink_to_fit();
-
-		this->normals.clear();
-		this->normals.shrink_to_fit();
+			return;
+		}
 
-		this->ambients.clear();
-		this->ambients.shrink_to_fit();
+		// Without the array the origin attribute is a constant, set before each draw
+		glDisableVertexAttribArray(1);
+		for (size_t i = 0; i < commands.size(); i++) {
+			const DrawElementsIndirectCommand& command = commands.getCommands()[i];
 
-		this->gpuDirty = false;
-	}
-	void markDirty() {
-		this->dirty = true;
+			glVertexAttrib3fv(1, &origins[i].x);
+			glDrawElementsBaseVertex(GL_TRIANGLES, command.count, GL_UNSIGNED_INT, nullptr, command.baseVertex);
+		}
+		glEnableVertexAttribArray(1);
 	}
 };
-
-class ChunkGenerator {
+// GPU copy of a ChunkMesh, a range of the TerrainBuffer
+class ChunkRenderer {
 private:
-	std::mutex blockChangeMutex, runningMutex;
-	FastNoise noise;
-public:
-	static const size_t CHUNKS_X = 12, CHUNKS_Y = 8, CHUNKS_Z = 12;
+	uint32_t allocation = VertexArena::INVALID;
+	GLsizei indexCount = 0;
 
-	Chunk* chunks = new Chunk[CHUNKS_X * CHUNKS_Y * CHUNKS_Z]();
-	ChunkMesh* chunkMeshes = new ChunkMesh[CHUNKS_X * CHUNKS_Y * CHUNKS_Z]();
+	glm::ivec3 position = glm::ivec3();
+public:
+	// Where the mesh is in terrainBuffer right now, ranges move when the buffer is defragmented
+	ChunkDraw getDraw(const TerrainBuffer& terrainBuffer) const {
+		if (this->indexCount == 0) return {};
 
-	ChunkGenerator() {
-		srand(0);
-		this->noise = FastNoise(std::chrono::high_resolution_clock::now().time_since_epoch().count());
-	}
-	~ChunkGenerator() {
-		delete[] this->chunks;
-		delete[] this->chunkMeshes;
+		return { .indexCount = static_cast<uint32_t>(this->indexCount), .baseVertex = terrainBuffer.getArena().getOffset(this->allocation), .position = this->position };
 	}
+	// Replaces the geometry of the chunk at position (in chunks) with a new build of its mesh
+	void upload(const glm::ivec3& position, const ChunkMeshData& data, TerrainBuffer& terrainBuffer) {
+		terrainBuffer.free(this->allocation);
 
-	void create() {
-		for (size_t x = 0; x < ChunkGenerator::CHUNKS_X; x++) {
-			for (size_t y = 0; y < ChunkGenerator::CHUNKS_Y; y++) {
-				for (size_t z = 0; z < ChunkGenerator::CHUNKS_Z; z++) {
-					size_t id = INDEX_FROM_XYZ(x, y, z, ChunkGenerator::CHUNKS_X, ChunkGenerator::CHUNKS_Z);
-
-					this->chunks[id].setGenerator(&this->noise);
-					this->chunks[id].create(glm::ivec3(x, y, z), ChunkGenerator::CHUNKS_Y);
-
-					this->chunkMeshes[id].connect(&this->chunks[id]);
-					this->chunkMeshes[id].markDirty();
-				}
-			}
-		}
-	}
-	void run(BS::Window* window) {
-		while (window->isRunning()) {
-			for (size_t x = 0; x < ChunkGenerator::CHUNKS_X; x++) {
-				for (size_t y = 0; y < ChunkGenerator::CHUNKS_Y; y++) {
-					for (size_t z = 0; z < ChunkGenerator::CHUNKS_Z; z++) {
-						this->chunkMeshes[INDEX_FROM_XYZ(x, y, z, ChunkGenerator::CHUNKS_X, ChunkGenerator::CHUNKS_Z)].update(
-							static_cast<uint16_t>(x) == ChunkGenerator::CHUNKS_X - 1 ? nullptr : &this->chunks[INDEX_FROM_XYZ(x + 1, y, z, ChunkGenerator::CHUNKS_X, ChunkGenerator::CHUNKS_Z)],
-																				x == 0 ? nullptr : &this->chunks[INDEX_FROM_XYZ(x - 1, y, z, ChunkGenerator::CHUNKS_X, ChunkGenerator::CHUNKS_Z)],
-							static_cast<uint16_t>(z) == ChunkGenerator::CHUNKS_Z - 1 ? nullptr : &this->chunks[INDEX_FROM_XYZ(x, y, z + 1, ChunkGenerator::CHUNKS_X, ChunkGenerator::CHUNKS_Z)],
-																				z == 0 ? nullptr : &this->chunks[INDEX_FROM_XYZ(x, y, z - 1, ChunkGenerator::CHUNKS_X, ChunkGenerator::CHUNKS_Z)],
-							static_cast<uint16_t>(y) == ChunkGenerator::CHUNKS_Y - 1 ? nullptr : &this->chunks[INDEX_FROM_XYZ(x, y + 1, z, ChunkGenerator::CHUNKS_X, ChunkGenerator::CHUNKS_Z)],
-																				y == 0 ? nullptr : &this->chunks[INDEX_FROM_XYZ(x, y - 1, z, ChunkGenerator::CHUNKS_X, ChunkGenerator::CHUNKS_Z)]
-						);
-					}
-				}
-			}
-		}
-	}
-
-	void setBlock(uint32_t x, uint32_t y, uint32_t z, uint8_t block) {
-		int chunkX = static_cast<int>(floor(x / Chunk::WIDTH));
-		int chunkY = static_cast<int>(floor(y / Chunk::HEIGHT));
-		int chunkZ = static_cast<int>(floor(z / Chunk::LENGTH));
-
-		if (chunkX < 0 || chunkY < 0 || chunkZ < 0 || chunkX >= CHUNKS_X || chunkY >= CHUNKS_Y || chunkZ >= CHUNKS_Z) return;
-		size_t index = INDEX_FROM_XYZ(chunkX, chunkY, chunkZ, CHUNKS_X, CHUNKS_Z);
-
-		uint16_t localX = x - chunkX * Chunk::WIDTH;
-		uint16_t localY = y - chunkY * Chunk::HEIGHT;
-		uint16_t localZ = z - chunkZ * Chunk::LENGTH;
-
-		this->chunks[index].setBlock(localX, localY, localZ, block);
-		this->chunkMeshes[index].markDirty();
-
-		if (localX == 0 && chunkX > 0) this->chunkMeshes[INDEX_FROM_XYZ(chunkX - 1, chunkY, chunkZ, CHUNKS_X, CHUNKS_Z)].markDirty();
-		if (localX == Chunk::WIDTH - 1 && chunkX < CHUNKS_X - 1) this->chunkMeshes[INDEX_FROM_XYZ(chunkX + 1, chunkY, chunkZ, CHUNKS_X, CHUNKS_Z)].markDirty();
-		if (localY == 0 && chunkY > 0) this->chunkMeshes[INDEX_FROM_XYZ(chunkX, chunkY - 1, chunkZ, CHUNKS_X, CHUNKS_Z)].markDirty();
-		if (localY == Chunk::HEIGHT - 1 && chunkY < CHUNKS_Y - 1) this->chunkMeshes[INDEX_FROM_XYZ(chunkX, chunkY + 1, chunkZ, CHUNKS_X, CHUNKS_Z)].markDirty();
-		if (localZ == 0 && chunkZ > 0) this->chunkMeshes[INDEX_FROM_XYZ(chunkX, chunkY, chunkZ - 1, CHUNKS_X, CHUNKS_Z)].markDirty();
-		if (localZ == Chunk::LENGTH - 1 && chunkZ < CHUNKS_Z - 1) this->chunkMeshes[INDEX_FROM_XYZ(chunkX, chunkY, chunkZ + 1, CHUNKS_X, CHUNKS_Z)].markDirty();
+		this->position = position;
+		this->indexCount = static_cast<GLsizei>(data.getIndexCount());
+		this->allocation = terrainBuffer.upload(data.vertices);
 	}
-	uint8_t getBlock(uint32_t x, uint32_t y, uint32_t z) const {
-		int chunkX = static_cast<int>(floor(x / Chunk::WIDTH));
-		int chunkY = static_cast<int>(floor(y / Chunk::HEIGHT));
-		int chunkZ = static_cast<int>(floor(z / Chunk::LENGTH));
-
-		if (chunkX < 0 || chunkY < 0 || chunkZ < 0 || chunkX >= CHUNKS_X || chunkY >= CHUNKS_Y || chunkZ >= CHUNKS_Z) return 0;
-		
-		return this->chunks[INDEX_FROM_XYZ(chunkX, chunkY, chunkZ, CHUNKS_X, CHUNKS_Z)].getBlock(
-			x - chunkX * Chunk::WIDTH,
-			y - chunkY * Chunk::HEIGHT,
-			z - chunkZ * Chunk::LENGTH
-		);
+	bool isEmpty() const {
+		return this->indexCount == 0;
 	}
 };
 
@@ -592,107 +225,13 @@ struct World {
 };
 class Camera {
 private:
-	static inline float clipVelocity(const glm::vec3& minA, const glm::vec3& maxA, const glm::vec3& minB, const glm::vec3& maxB, float velocity, size_t axis) {
-		int x = axis;
-		int y = x + 1 >= 3 ? 0 : x + 1;
-		int z = y + 1 >= 3 ? 0 : y + 1;
-
-		if (minA[y] >= maxB[y] || maxA[y] <= minB[y]) {
-			return velocity;
-		}
-		if (minA[z] >= maxB[z] || maxA[z] <= minB[z]) {
-			return velocity;
-		}
-
-		if (velocity > 0.0f && maxA[x] <= minB[x]) {
-			float difference = minB[x] - maxA[x] - 0.01f;
-			if (difference < velocity) {
-				return difference;
-			}
-		}
-		if (velocity < 0.0f && minA[x] >= maxB[x]) {
-			float difference = maxB[x] - minA[x] + 0.01f;
-			if (difference > velocity) {
-				return difference;
-			}
-		}
-
-		return velocity;
-	}
-
 	void collide(const ChunkGenerator& chunkGenerator, const float delta) {
-		glm::vec3 boxMin = this->position;
-		glm::vec3 boxMax = this->position + this->scale;
-
-		float scaledVx = this->velocity.x * delta;
-		float scaledVy = this->velocity.y * delta;
-		float scaledVz = this->velocity.z * delta;
-
-		float originVx = scaledVx;
-		float originVy = scaledVy;
-		float originVz = scaledVz;
-
-		float velocity = abs(scaledVy);
-		for (int x = (int)boxMin.x; x <= (int)boxMax.x; ++x) {
-			for (int y = (int)(boxMin.y - velocity) - 1; y <= (int)(boxMax.y + velocity) + 1; ++y) {
-				for (int z = (int)boxMin.z; z <= (int)boxMax.z; ++z) {
-					uint8_t block = chunkGenerator.getBlock(x, y, z);
-					if (block == 0) {
-						continue;
-					}
-
-					glm::vec3 blockMin = glm::vec3(x, y, z);
-					glm::vec3 blockMax = glm::vec3(blockMin) + 1.0f;
-
-					scaledVy = Camera::clipVelocity(boxMin, boxMax, blockMin, blockMax, scaledVy, 1);
-				}
-			}
-		}
-		this->position.y += scaledVy;
-
-		// X collision
-		boxMin = this->position;
-		boxMax = this->position + this->scale;
-
-		velocity = abs(scaledVx);
-		for (int x = (int)(boxMin.x - velocity) - 1; x <= (int)(boxMax.x + velocity) + 1; ++x) {
-			for (int y = (int)boxMin.y; y <= (int)boxMax.y; ++y) {
-				for (int z = (int)boxMin.z; z <= (int)boxMax.z; ++z) {
-					uint8_t block = chunkGenerator.getBlock(x, y, z);
-					if (block == 0) {
-						continue;
-					}
-
-					glm::vec3 blockMin = glm::vec3(x, y, z);
-					glm::vec3 blockMax = glm::vec3(blockMin) + 1.0f;
-
-					scaledVx = Camera::clipVelocity(boxMin, boxMax, blockMin, blockMax, scaledVx, 0);
-				}
-			}
-		}
-		this->position.x += scaledVx;
-
-		// Z collision
-		boxMin = this->position;
-		boxMax = this->position + this->scale;
-
-		velocity = abs(scaledVz);
-		for (int x = (int)boxMin.x; x <= (int)boxMax.x; ++x) {
-			for (int y = (int)boxMin.y; y <= (int)boxMax.y; ++y) {
-				for (int z = (int)(boxMin.z - velocity) - 1; z <= (int)(boxMax.z + velocity) + 1; ++z) {
-					uint8_t block = chunkGenerator.getBlock(x, y, z);
-					if (block == 0) {
-						continue;
-					}
-
-					glm::vec3 blockMin = glm::vec3(x, y, z);
-					glm::vec3 blockMax = glm::vec3(blockMin) + 1.0f;
-
-					scaledVz = Camera::clipVelocity(boxMin, boxMax, blockMin, blockMax, scaledVz, 2);
-				}
-			}
-		}
-		this->position.z += scaledVz;
+		glm::vec3 motion = this->velocity * delta;
+		glm::vec3 applied = Collision::move(chunkGenerator, this->position, this->scale, motion);
+
+		float scaledVx = applied.x, originVx = motion.x;
+		float scaledVy = applied.y, originVy = motion.y;
+		float scaledVz = applied.z, originVz = motion.z;
 
 		if (originVy != 0.0f) {
 			this->onGround = false;
@@ -742,12 +281,14 @@ private:
 
 	float currentFov = 90.0f;
 public:
-	glm::vec3 position, rotation, scale, velocity = glm::vec3();
+	// In double so the eye stays precise however far the camera is from the origin
+	glm::dvec3 position;
+	glm::vec3 rotation, scale, velocity = glm::vec3();
 	
 	float speed = 4.0f, runSpeed = 5.0f;
 	float fov = 90.0f, runFov = 100.0f;
 
-	Camera(glm::vec3 position = glm::vec3(), glm::vec3 rotation = glm::vec3(), glm::vec3 scale = glm::vec3(0.5f, 1.82f, 0.5f)) :
+	Camera(glm::dvec3 position = glm::dvec3(), glm::vec3 rotation = glm::vec3(), glm::vec3 scale = glm::vec3(0.5f, 1.82f, 0.5f)) :
 		position(position),
 		rotation(rotation),
 		scale(scale)
@@ -811,7 +352,7 @@ public:
 		this->rotation.x = glm::clamp(this->rotation.x, -90.0f, 90.0f);
 		this->rotation.y -= floor(this->rotation.y / 360.0f) * 360.0f;
 
-		if (this->debugMode) this->position += this->velocity * timer.getDelta();
+		if (this->debugMode) this->position += glm::dvec3(this->velocity * timer.getDelta());
 		else this->collide(chunkGenerator, timer.getDelta());
 
 		glm::vec2 rawBobbingOffset = glm::vec2();
@@ -831,60 +372,56 @@ public:
 		this->currentFov = glm::mix(this->currentFov, this->running ? this->runFov : this->fov, 6.0f * timer.getDelta());
 	}
 
-	glm::mat4 getProjectViewMatrix(BS::Window* window) const {
-		return MatrixHelper::perspective(window, this->currentFov) * MatrixHelper::view(
-			this->getEyePosition(),
-			this->rotation
-		);
+	// View matrix without the eye translation, for geometry that is already positioned relative to the eye
+	glm::mat4 getProjectRotationMatrix(BS::Window* window) const {
+		return MatrixHelper::perspective(window, this->currentFov) * MatrixHelper::view(glm::vec3(), this->rotation);
 	}
 
-	glm::vec3 getEyePosition() const {
+	glm::dvec3 getEyePosition() const {
 		return
 			this->position +
-			glm::vec3(this->scale.x * 0.5f, this->scale.y - 0.1f, this->scale.z * 0.5f) +
+			glm::dvec3(glm::vec3(this->scale.x * 0.5f, this->scale.y - 0.1f, this->scale.z * 0.5f) +
 			glm::vec3(
 				this->bobbingOffset.x * cos(glm::radians(this->rotation.y)),
 				this->bobbingOffset.y,
 				this->bobbingOffset.x * -sin(glm::radians(this->rotation.y))
-			);
+			));
 	}
 };
 
 class MainWindow : public BS::Window {
 private:
 	BS::Timer timer;
-	Camera camera = Camera(glm::vec3(84.0f, 72.0f, 222.0f), glm::vec3(-45.0f, 0.0f, 0.0f));
+	Camera camera = Camera(glm::dvec3(84.0, 72.0, 222.0), glm::vec3(-45.0f, 0.0f, 0.0f));
 
 	BS::ShaderProgram terrainShader = BS::ShaderProgram("assets/shaders/terrain.vsh", "assets/shaders/terrain.fsh", nullptr);
 
 	float fpsTimer = 0.0f;
 	int fps = 0;
-private:
-	void createBlob(uint16_t x, uint16_t y, uint16_t z, uint8_t block, int blobSize = 12, bool noisy = false) {		
-		for (int ox = -blobSize; ox < blobSize; ox++) {
-			for (int oy = -blobSize; oy < blobSize; oy++) {
-				for (int oz = -blobSize; oz < blobSize; oz++) {
-					if (glm::length(glm::vec3(ox, oy, oz)) <= blobSize - (noisy ? rand() % 10000 / 10000.0f : 0)) {
-						this->chunkGenerator.setBlock(
-							x + ox,
-							y + oy,
-							z + oz,
-							block
-						);
-					}
-				}
-			}
-		}
-	}
+	// Frame times since the last report (H)
+	FrameHistogram frameTimes;
 
 	const BlockTextureAtlas blockTextureAtlas;
 	
 	World world;
 	ChunkGenerator chunkGenerator;
+	ChunkRenderer* chunkRenderers = new ChunkRenderer[ChunkGenerator::CHUNKS_X * ChunkGenerator::CHUNKS_Y * ChunkGenerator::CHUNKS_Z]();
+	GLuint quadIndexBufferId = 0;
+	TerrainBuffer* terrainBuffer = nullptr;
+	// Built meshes wait here and are uploaded nearest first, a few megabytes per frame
+	UploadScheduler uploads = UploadScheduler(ChunkGenerator::CHUNKS_X * ChunkGenerator::CHUNKS_Y * ChunkGenerator::CHUNKS_Z);
+	DrawCommandList drawCommands;
+	DrawableChunks drawableChunks = DrawableChunks(ChunkGenerator::CHUNKS_X * ChunkGenerator::CHUNKS_Y * ChunkGenerator::CHUNKS_Z);
+	// Chunks the view frustum touches this frame, and how many it left out
+	std::vector<uint8_t> visibleChunks;
+	size_t culledChunks = 0;
+
+	// Blob placement randomness, seeded with the world so a run can be replayed
+	std::mt19937 random;
 
 	std::thread chunkGeneratorThread;
 public:
-	MainWindow() : Window(1920, 1080, "MineStorm"), blockTextureAtlas(BlockTextureAtlas::create()) {
+	MainWindow(int seed) : Window(1920, 1080, "MineStorm"), blockTextureAtlas(BlockTextureAtlas::create()), chunkGenerator(seed), random(seed) {
 		//this->disableVSync();
 		this->grabMouse();
 
@@ -898,26 +435,46 @@ public:
 
 		//glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
-		Blocks::registerEntry(Block::create(BlockFace(glm::ivec2(3, 15)), BlockFace(glm::ivec2(0, 15)), BlockFace(glm::ivec2(2, 15))));
-		Blocks::registerEntry(Block::create(BlockFace(glm::ivec2(1, 15))));
-		Blocks::registerEntry(Block::create(BlockFace(glm::ivec2(1, 14))));
-		Blocks::registerEntry(Block::create(BlockFace(glm::ivec2(2, 15))));
+		Blocks::registerDefaults();
+		this->quadIndexBufferId = TerrainBuffer::createIndexBuffer();
+		// Enough for the world at full detail with greedy meshing, it grows when needed
+		this->terrainBuffer = new TerrainBuffer(1 << 22, this->quadIndexBufferId);
 
-		this->chunkGenerator.create();
+		// Meshes are built along with the terrain, the world streams in over the first frames as the upload budget allows
+		this->chunkGenerator.setGreedyMeshing(true);
+		this->chunkGenerator.setViewPosition(this->camera.getEyePosition());
+		this->chunkGenerator.setLodEnabled(true);
+		this->chunkGenerator.create(true, true);
 		
-		this->chunkGeneratorThread = std::thread(&ChunkGenerator::run, &this->chunkGenerator, this);
-		if (this->chunkGeneratorThread.joinable()) this->chunkGeneratorThread.detach();
+		// Sleeps until blocks change or the view enters another chunk
+		this->chunkGeneratorThread = std::thread(&ChunkGenerator::run, &this->chunkGenerator, [this]() { return this->isRunning(); });
+	}
+	~MainWindow() {
+		this->chunkGenerator.stop();
+		if (this->chunkGeneratorThread.joinable()) this->chunkGeneratorThread.join();
+
+		delete[] this->chunkRenderers;
+		delete this->terrainBuffer;
+		glDeleteBuffers(1, &this->quadIndexBufferId);
 	}
 
 	void onUpdate() override {
 		this->timer.update();
 		this->camera.update(*this, this->world, this->chunkGenerator, this->timer);
+		this->chunkGenerator.setViewPosition(this->camera.getEyePosition());
 
 		this->fpsTimer += this->timer.getRealDelta();
 		this->fps++;
+		this->frameTimes.add(this->timer.getRealDelta() * 1000.0);
 		
 		if (this->fpsTimer >= 1.0f) {
-			this->setTitle(std::string("MineStorm | FPS: " + std::to_string(this->fps)).c_str());
+			// Milliseconds from queueing a mesh until its build was ready, for edits and for chunks in view
+			RemeshLatency edits, visible;
+			this->chunkGenerator.takeRemeshLatency(edits, visible);
+
+			this->setTitle(std::string("MineStorm | FPS: " + std::to_string(this->fps) + " | Chunks drawn: " + std::to_string(this->drawCommands.size()) + ", culled: " + std::to_string(this->culledChunks) + ", uploads pending: " + std::to_string(this->uploads.getPendingCount()) +
+				" | Remesh ms edit: " + std::to_string(static_cast<int>(edits.getAverage())) + " (max " + std::to_string(static_cast<int>(edits.max)) + ")" +
+				", visible: " + std::to_string(static_cast<int>(visible.getAverage())) + " (max " + std::to_string(static_cast<int>(visible.max)) + ")").c_str());
 			
 			this->fpsTimer = 0.0f;
 			this->fps = 0;
@@ -926,46 +483,87 @@ public:
 		if (this->isKeyJustPressed(BS::KeyCode::ESCAPE)) {
 			this->toggleMouse();
 		}
+		if (this->isKeyJustPressed(BS::KeyCode::G)) {
+			bool greedy = !this->chunkGenerator.chunkMeshes[0].isGreedy();
+			this->chunkGenerator.setGreedyMeshing(greedy);
+
+			BS::Logger::info("Greedy meshing %s", greedy ? "on" : "off");
+		}
+		if (this->isKeyJustPressed(BS::KeyCode::H)) {
+			BS::Logger::info("Frame times over %zu frames: %s", this->frameTimes.getFrames(), this->frameTimes.toString().c_str());
+			this->frameTimes.clear();
+		}
+		if (this->isKeyJustPressed(BS::KeyCode::L)) {
+			bool lod = !this->chunkGenerator.isLodEnabled();
+			this->chunkGenerator.setLodEnabled(lod);
+
+			BS::Logger::info("Level of detail %s", lod ? "on" : "off");
+		}
 
 		if (this->isMouseButtonPressed(BS::MouseButton::LEFT)) {
-			uint16_t x = rand() % (ChunkGenerator::CHUNKS_X * Chunk::WIDTH);
-			uint16_t y = rand() % (ChunkGenerator::CHUNKS_Y * Chunk::HEIGHT);
-			uint16_t z = rand() % (ChunkGenerator::CHUNKS_Z * Chunk::LENGTH);
+			uint16_t x = this->random() % (ChunkGenerator::CHUNKS_X * Chunk::WIDTH);
+			uint16_t y = this->random() % (ChunkGenerator::CHUNKS_Y * Chunk::HEIGHT);
+			uint16_t z = this->random() % (ChunkGenerator::CHUNKS_Z * Chunk::LENGTH);
 
-			this->createBlob(x, y, z, 1);
+			this->chunkGenerator.createBlob(x, y, z, 1);
 		}
 		if (this->isMouseButtonJustPressed(BS::MouseButton::RIGHT)) {
-			uint16_t x = rand() % (ChunkGenerator::CHUNKS_X * Chunk::WIDTH);
-			uint16_t y = rand() % (ChunkGenerator::CHUNKS_Y * Chunk::HEIGHT);
-			uint16_t z = rand() % (ChunkGenerator::CHUNKS_Z * Chunk::LENGTH);
+			uint16_t x = this->random() % (ChunkGenerator::CHUNKS_X * Chunk::WIDTH);
+			uint16_t y = this->random() % (ChunkGenerator::CHUNKS_Y * Chunk::HEIGHT);
+			uint16_t z = this->random() % (ChunkGenerator::CHUNKS_Z * Chunk::LENGTH);
 
-			this->createBlob(x, y, z, 0, 16, true);
+			this->chunkGenerator.createBlob(x, y, z, 0, 16, &this->random);
 		}
 
-		glm::mat4 projectViewMatrix = this->camera.getProjectViewMatrix(this);
+		glm::mat4 projectRotationMatrix = this->camera.getProjectRotationMatrix(this);
+		glm::dvec3 eyePosition = this->camera.getEyePosition();
+
+		// Meshes in view are rebuilt first
+		Frustum frustum = Frustum::fromMatrix(projectRotationMatrix);
+		this->chunkGenerator.setViewFrustum(frustum);
 
 		this->terrainShader.use();
-		this->terrainShader.setVector3("eyePosition", this->camera.getEyePosition());
 		this->terrainShader.setVector3("fogColor", glm::vec3(186 / 255.0f, 210 / 255.0f, 255 / 255.0f));
+		this->terrainShader.setVector2("tileSize", BlockFace::SCALAR_X, BlockFace::SCALAR_Y);
+		this->terrainBuffer->use();
+
+		// Upload first, an upload can defragment the terrain buffer and move meshes uploaded before it
+		uint32_t id;
+		ChunkMeshData data;
+		while (this->chunkGenerator.takeMesh(id, data)) {
+			this->uploads.add(id, this->chunkGenerator.chunks[id].getPosition(), std::move(data));
+		}
+		this->uploads.upload(eyePosition, [this](uint32_t id, const ChunkMeshData& data) {
+			this->chunkRenderers[id].upload(this->chunkGenerator.chunks[id].getPosition(), data, *this->terrainBuffer);
+			this->drawableChunks.set(id, !this->chunkRenderers[id].isEmpty());
+		});
+
+		this->culledChunks = ChunkCulling::cull(
+			frustum, eyePosition,
+			glm::ivec3(ChunkGenerator::CHUNKS_X, ChunkGenerator::CHUNKS_Y, ChunkGenerator::CHUNKS_Z), this->visibleChunks
+		);
 
-		for (size_t x = 0; x < ChunkGenerator::CHUNKS_X; x++) {
-			for (size_t y = 0; y < ChunkGenerator::CHUNKS_Y; y++) {
-				for (size_t z = 0; z < ChunkGenerator::CHUNKS_Z; z++) {
-					size_t id = INDEX_FROM_XYZ(x, y, z, ChunkGenerator::CHUNKS_X, ChunkGenerator::CHUNKS_Z);
-
-					this->chunkGenerator.chunkMeshes[id].saveToGPU();
-
-					this->chunkGenerator.chunkMeshes[id].use();
-					this->chunkGenerator.chunkMeshes[id].render(this->terrainShader, this->blockTextureAtlas, projectViewMatrix);
-				}
-			}
+		this->drawCommands.clear();
+		for (uint32_t id : this->drawableChunks.getIds()) {
+			if (this->visibleChunks[id]) this->drawCommands.add(this->chunkRenderers[id].getDraw(*this->terrainBuffer), eyePosition);
 		}
+
+		// Chunks are placed relative to the eye (in double) so vertex positions stay small and precise however far the camera is from the origin
+		BS::Texture::use(this->blockTextureAtlas.id);
+		this->terrainShader.setMatrix4("mvpMatrix", projectRotationMatrix);
+		this->terrainBuffer->draw(this->drawCommands);
 	}
 };
 
-int main() {
+int main(int argc, char** argv) {
+	// Without --seed every run is a new world, the seed is logged so it can be replayed
+	int seed = static_cast<int>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+	if (argc > 2 && strcmp(argv[1], "--seed") == 0) seed = atoi(argv[2]);
+
 	BS::initialize();
-	BS::registerWindow(new MainWindow());
+	BS::Logger::info("World seed: %d", seed);
+
+	BS::registerWindow(new MainWindow(seed));
 
 	return BS::run();
 }
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+#include <cstdio>
+
+// Every test executable counts its failed checks and returns 1 from main() when there was any, ctest reports the ones printed
+namespace Check {
+	inline int failures = 0;
+
+	inline int result() {
+		if (Check::failures != 0) fprintf(stderr, "%d checks failed\n", Check::failures);
+		return Check::failures == 0 ? 0 : 1;
+	}
+}
+
+#define CHECK(condition) do { if (!(condition)) { fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); Check::failures++; } } while (false)
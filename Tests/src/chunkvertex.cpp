@@ -0,0 +1,39 @@
+#include <core.h>
+
+#include "check.h"
+
+// Every field at its extremes (and a few values in between) survives pack() and unpack(), and bit 31 stays free
+int main() {
+	const uint8_t positions[] = { 0, 1, 16, 31, 32 };
+	const uint8_t tiles[] = { 0, 1, 14, 15 };
+
+	for (uint8_t x : positions) {
+		for (uint8_t y : positions) {
+			for (uint8_t z : positions) {
+				for (uint8_t side = 0; side < 6; side++) {
+					for (uint8_t ambient = 0; ambient < 4; ambient++) {
+						for (uint8_t tileX : tiles) {
+							for (uint8_t tileY : tiles) {
+								ChunkVertex vertex = { .position = glm::u8vec3(x, y, z), .side = side, .ambient = ambient, .tile = glm::u8vec2(tileX, tileY) };
+								uint32_t packed = ChunkVertex::pack(vertex);
+								ChunkVertex unpacked = ChunkVertex::unpack(packed);
+
+								CHECK((packed & 0x80000000u) == 0);
+								CHECK(unpacked.position == vertex.position);
+								CHECK(unpacked.side == side);
+								CHECK(unpacked.ambient == ambient);
+								CHECK(unpacked.tile == vertex.tile);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// The largest value of every field sets exactly bits 0 - 30
+	ChunkVertex full = { .position = glm::u8vec3(63), .side = 7, .ambient = 3, .tile = glm::u8vec2(15) };
+	CHECK(ChunkVertex::pack(full) == 0x7FFFFFFFu);
+
+	return Check::result();
+}
@@ -0,0 +1,93 @@
+#include <core.h>
+
+#include <random>
+#include <algorithm>
+
+#include "check.h"
+
+static void commandList() {
+	DrawCommandList commands;
+	const glm::i64vec3 chunkSize = glm::i64vec3(Chunk::WIDTH, Chunk::HEIGHT, Chunk::LENGTH);
+
+	// About 2 ^ 31 blocks out, where a float position would have lost all sub block precision
+	glm::ivec3 far = glm::ivec3(1 << 26, -3, -(1 << 26));
+	glm::dvec3 eyePosition = glm::dvec3(glm::i64vec3(far) * chunkSize) + glm::dvec3(1.5, 2.25, -0.75);
+
+	commands.add({ .indexCount = 0, .baseVertex = 7, .position = far }, eyePosition);
+	commands.add({ .indexCount = 36, .baseVertex = 1024, .position = far }, eyePosition);
+	commands.add({ .indexCount = 0, .baseVertex = 9, .position = far }, eyePosition);
+	commands.add({ .indexCount = 6, .baseVertex = 4096, .position = far + glm::ivec3(1, 0, -2) }, eyePosition);
+
+	// Empty draws get no command, the others are numbered in the order they were added
+	CHECK(commands.size() == 2);
+	CHECK(commands.getOrigins().size() == 2);
+
+	const std::vector<DrawElementsIndirectCommand>& list = commands.getCommands();
+	for (size_t i = 0; i < list.size(); i++) {
+		CHECK(list[i].baseInstance == i);
+		CHECK(list[i].instanceCount == 1);
+		CHECK(list[i].firstIndex == 0);
+	}
+
+	CHECK(list[0].count == 36 && list[0].baseVertex == 1024);
+	CHECK(list[1].count == 6 && list[1].baseVertex == 4096);
+
+	// Origins are exact, they are subtracted before the conversion to float
+	CHECK(commands.getOrigins()[0] == glm::vec3(-1.5f, -2.25f, 0.75f));
+	CHECK(commands.getOrigins()[1] == glm::vec3(32.0f - 1.5f, -2.25f, -64.0f + 0.75f));
+
+	commands.clear();
+	CHECK(commands.size() == 0 && commands.getOrigins().empty());
+}
+
+// Random sets and removals against a plain flag per id, ids stay unique and every id is in the list exactly while it is drawable
+static void drawableChunks() {
+	const uint32_t COUNT = 200;
+	DrawableChunks drawable = DrawableChunks(COUNT);
+	std::vector<uint8_t> expected(COUNT, 0);
+	std::mt19937 random(20);
+
+	CHECK(drawable.size() == 0);
+
+	for (int step = 0; step < 20000; step++) {
+		uint32_t id = random() % COUNT;
+		bool value = random() % 3 != 0;
+
+		drawable.set(id, value);
+		expected[id] = value;
+
+		if (step % 500 != 0) continue;
+
+		std::vector<uint32_t> ids = drawable.getIds();
+		std::sort(ids.begin(), ids.end());
+		CHECK(std::adjacent_find(ids.begin(), ids.end()) == ids.end());
+		CHECK(ids.size() == static_cast<size_t>(std::count(expected.begin(), expected.end(), 1)));
+
+		for (uint32_t other = 0; other < COUNT; other++) {
+			CHECK(drawable.contains(other) == (expected[other] != 0));
+			CHECK(std::binary_search(ids.begin(), ids.end(), other) == (expected[other] != 0));
+		}
+	}
+
+	// Removing the last id and one from the middle, the last one takes its place
+	DrawableChunks small = DrawableChunks(4);
+	small.set(0, true);
+	small.set(1, true);
+	small.set(2, true);
+	small.set(1, false);
+	CHECK(small.getIds() == std::vector<uint32_t>({ 0, 2 }));
+	small.set(2, false);
+	CHECK(small.getIds() == std::vector<uint32_t>({ 0 }));
+	small.set(3, false);
+	small.set(0, true);
+	CHECK(small.getIds() == std::vector<uint32_t>({ 0 }));
+	small.set(1, true);
+	CHECK(small.getIds() == std::vector<uint32_t>({ 0, 1 }));
+}
+
+int main() {
+	commandList();
+	drawableChunks();
+
+	return Check::result();
+}
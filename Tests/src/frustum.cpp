@@ -0,0 +1,136 @@
+#include <core.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <random>
+
+#include "check.h"
+
+static const glm::ivec3 CHUNKS = glm::ivec3(ChunkGenerator::CHUNKS_X, ChunkGenerator::CHUNKS_Y, ChunkGenerator::CHUNKS_Z);
+
+// The game's projection times its view rotation, without the eye translation (see Camera::getProjectRotationMatrix)
+static glm::mat4 getProjectRotationMatrix(float pitch, float yaw) {
+	glm::mat4 rotation = glm::mat4(1.0f);
+	rotation = glm::rotate(rotation, -glm::radians(pitch), glm::vec3(1.0f, 0.0f, 0.0f));
+	rotation = glm::rotate(rotation, -glm::radians(yaw), glm::vec3(0.0f, 1.0f, 0.0f));
+
+	return glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.01f, 500.0f) * rotation;
+}
+
+// Brute force reference: a chunk is visible when any of 5 x 5 x 5 points spread over it (corners included) is inside the clip volume
+// Points miss slivers, so this only proves chunks visible, and then cull() must not have culled them
+static bool isSampledVisible(const glm::mat4& matrix, const glm::dvec3& eyePosition, int x, int y, int z) {
+	for (int sampleX = 0; sampleX <= 4; sampleX++) {
+		for (int sampleY = 0; sampleY <= 4; sampleY++) {
+			for (int sampleZ = 0; sampleZ <= 4; sampleZ++) {
+				glm::dvec3 point = (glm::dvec3(x, y, z) + glm::dvec3(sampleX, sampleY, sampleZ) * 0.25) * glm::dvec3(Chunk::WIDTH, Chunk::HEIGHT, Chunk::LENGTH);
+				glm::vec4 clip = matrix * glm::vec4(glm::vec3(point - eyePosition), 1.0f);
+
+				if (clip.w > 0.0f && fabs(clip.x) <= clip.w && fabs(clip.y) <= clip.w && fabs(clip.z) <= clip.w) return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+// Returns how many chunks were culled, every sampled visible chunk has to be kept
+static size_t checkView(const glm::mat4& matrix, const glm::dvec3& eyePosition) {
+	std::vector<uint8_t> visible;
+	size_t culled = ChunkCulling::cull(Frustum::fromMatrix(matrix), eyePosition, CHUNKS, visible);
+
+	size_t kept = 0;
+	for (int x = 0; x < CHUNKS.x; x++) {
+		for (int y = 0; y < CHUNKS.y; y++) {
+			for (int z = 0; z < CHUNKS.z; z++) {
+				bool shown = visible[INDEX_FROM_XYZ(x, y, z, CHUNKS.x, CHUNKS.z)] != 0;
+				kept += shown;
+
+				if (!shown && isSampledVisible(matrix, eyePosition, x, y, z)) {
+					fprintf(stderr, "Chunk %d %d %d is visible but was culled\n", x, y, z);
+					CHECK(false);
+				}
+			}
+		}
+	}
+
+	CHECK(kept + culled == visible.size());
+	return culled;
+}
+
+static void randomViews() {
+	std::mt19937 random(19);
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+	size_t culled = 0;
+
+	for (int view = 0; view < 60; view++) {
+		glm::dvec3 eyePosition = glm::dvec3(unit(random) * 1.5 - 0.25, unit(random), unit(random) * 1.5 - 0.25) * glm::dvec3(CHUNKS * glm::ivec3(Chunk::WIDTH, Chunk::HEIGHT, Chunk::LENGTH));
+		culled += checkView(getProjectRotationMatrix(static_cast<float>(unit(random) * 180.0 - 90.0), static_cast<float>(unit(random) * 360.0)), eyePosition);
+	}
+
+	// Culling has to actually leave chunks out, not just keep everything
+	CHECK(culled > 60 * CHUNKS.x * CHUNKS.y * CHUNKS.z / 2);
+}
+
+static void eyeInsideChunk() {
+	// In the middle of chunk (5, 3, 5) the near plane always cuts through it, whatever the direction
+	// On the corner of chunk (6, 4, 6) it may be behind the eye, there only the brute force check applies
+	glm::dvec3 middle = glm::dvec3(5.5, 3.5, 5.5) * 32.0, corner = glm::dvec3(6.0, 4.0, 6.0) * 32.0;
+
+	for (float yaw = 0.0f; yaw < 360.0f; yaw += 45.0f) {
+		for (float pitch = -90.0f; pitch <= 90.0f; pitch += 45.0f) {
+			std::vector<uint8_t> visible;
+			glm::mat4 matrix = getProjectRotationMatrix(pitch, yaw);
+
+			ChunkCulling::cull(Frustum::fromMatrix(matrix), middle, CHUNKS, visible);
+			CHECK(visible[INDEX_FROM_XYZ(5, 3, 5, CHUNKS.x, CHUNKS.z)] == 1);
+
+			checkView(matrix, middle);
+			checkView(matrix, corner);
+		}
+	}
+}
+
+static void straightUpAndDown() {
+	glm::dvec3 eyePosition = glm::dvec3(6.2, 4.1, 5.7) * 32.0;
+
+	for (float yaw : { 0.0f, 37.0f, 90.0f }) {
+		// Straight down from the middle of the world culls everything above the eye, straight up everything below
+		std::vector<uint8_t> visible;
+		ChunkCulling::cull(Frustum::fromMatrix(getProjectRotationMatrix(-90.0f, yaw)), eyePosition, CHUNKS, visible);
+		CHECK(visible[INDEX_FROM_XYZ(6, 7, 5, CHUNKS.x, CHUNKS.z)] == 0);
+		CHECK(visible[INDEX_FROM_XYZ(6, 0, 5, CHUNKS.x, CHUNKS.z)] == 1);
+
+		ChunkCulling::cull(Frustum::fromMatrix(getProjectRotationMatrix(90.0f, yaw)), eyePosition, CHUNKS, visible);
+		CHECK(visible[INDEX_FROM_XYZ(6, 0, 5, CHUNKS.x, CHUNKS.z)] == 0);
+		CHECK(visible[INDEX_FROM_XYZ(6, 7, 5, CHUNKS.x, CHUNKS.z)] == 1);
+
+		checkView(getProjectRotationMatrix(-90.0f, yaw), eyePosition);
+		checkView(getProjectRotationMatrix(90.0f, yaw), eyePosition);
+	}
+}
+
+static void nearPlane() {
+	// Looking down -z, the near plane is 0.01 in front of the eye
+	Frustum frustum = Frustum::fromMatrix(getProjectRotationMatrix(0.0f, 0.0f));
+
+	// Straddling the near plane, the part past it is in view
+	CHECK(frustum.classify(glm::vec3(-0.5f, -0.5f, -1.0f), glm::vec3(0.5f, 0.5f, 0.005f)) == Frustum::Intersecting);
+	// Around the eye
+	CHECK(frustum.classify(glm::vec3(-1.0f), glm::vec3(1.0f)) == Frustum::Intersecting);
+	// Entirely between the eye and the near plane, and entirely behind the eye
+	CHECK(frustum.classify(glm::vec3(-0.001f, -0.001f, -0.005f), glm::vec3(0.001f, 0.001f, -0.002f)) == Frustum::Outside);
+	CHECK(frustum.classify(glm::vec3(-1.0f, -1.0f, 1.0f), glm::vec3(1.0f, 1.0f, 2.0f)) == Frustum::Outside);
+	// Well inside
+	CHECK(frustum.classify(glm::vec3(-1.0f, -1.0f, -20.0f), glm::vec3(1.0f, 1.0f, -10.0f)) == Frustum::Inside);
+	// Past the far plane
+	CHECK(frustum.classify(glm::vec3(-1.0f, -1.0f, -600.0f), glm::vec3(1.0f, 1.0f, -550.0f)) == Frustum::Outside);
+}
+
+int main() {
+	randomViews();
+	eyeInsideChunk();
+	straightUpAndDown();
+	nearPlane();
+
+	return Check::result();
+}
@@ -0,0 +1,104 @@
+#include <core.h>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+#include "check.h"
+
+// The three threads ChunkGenerator is made for, racing for a while: one edits the world and changes the settings, run() meshes it
+// and this thread takes the builds like the renderer does. Afterwards every chunk's last build taken has to be the current version,
+// and equal to a fresh rebuild of the final world. Build with MINESTORM_TSAN to have ThreadSanitizer watch the whole run
+int main(int argc, char** argv) {
+	double seconds = argc > 1 ? atof(argv[1]) : 3.0;
+	const size_t CHUNK_COUNT = ChunkGenerator::CHUNKS_X * ChunkGenerator::CHUNKS_Y * ChunkGenerator::CHUNKS_Z;
+
+	Blocks::registerDefaults();
+	std::unique_ptr<ChunkGenerator> chunkGenerator = std::make_unique<ChunkGenerator>(77, 1, 3);
+	chunkGenerator->setGreedyMeshing(true);
+	chunkGenerator->setViewPosition(glm::dvec3(100.0, 150.0, 100.0));
+	chunkGenerator->setLodEnabled(true);
+	chunkGenerator->create(true, true);
+
+	std::thread mesher(&ChunkGenerator::run, chunkGenerator.get(), []() { return true; });
+
+	std::atomic<bool> editing = true;
+	std::thread editor([&]() {
+		std::mt19937 random(5);
+
+		for (int step = 0; editing; step++) {
+			int x = random() % (ChunkGenerator::CHUNKS_X * Chunk::WIDTH);
+			int y = random() % (ChunkGenerator::CHUNKS_Y * Chunk::HEIGHT);
+			int z = random() % (ChunkGenerator::CHUNKS_Z * Chunk::LENGTH);
+
+			if (step % 3 == 0) chunkGenerator->createBlob(x, y, z, random() % 2 ? 0 : 2, 6, &random);
+			else chunkGenerator->setBlock(x, y, z, random() % 5);
+
+			if (step % 7 == 0) {
+				chunkGenerator->setViewPosition(glm::dvec3(random() % 384, random() % 256, random() % 384));
+				chunkGenerator->setViewFrustum(Frustum::fromMatrix(glm::perspective(1.2f, 1.5f, 0.1f, 500.0f) * glm::rotate(glm::mat4(1.0f), step * 0.1f, glm::vec3(0.0f, 1.0f, 0.0f))));
+			}
+			if (step % 50 == 0) chunkGenerator->setLodEnabled(step % 100 == 0);
+			if (step % 90 == 0) chunkGenerator->setGreedyMeshing(step % 180 == 0);
+
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+	});
+
+	// Last build taken per chunk, what a renderer would be showing
+	std::vector<ChunkMeshData> shown(CHUNK_COUNT);
+	std::vector<uint8_t> taken(CHUNK_COUNT, 0);
+	size_t builds = 0;
+	auto take = [&]() {
+		uint32_t id;
+		ChunkMeshData data;
+
+		while (chunkGenerator->takeMesh(id, data)) {
+			shown[id] = std::move(data);
+			taken[id] = 1;
+			builds++;
+		}
+	};
+
+	auto start = std::chrono::steady_clock::now();
+	while (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() < seconds) {
+		take();
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	}
+
+	editing = false;
+	editor.join();
+	chunkGenerator->stop();
+	mesher.join();
+
+	// This thread is the mesher now, whatever is still queued is built and taken
+	chunkGenerator->updateMeshes();
+	take();
+
+	// More than the builds of create(), edits were meshed while the race was on
+	CHECK(builds > CHUNK_COUNT);
+	for (size_t id = 0; id < CHUNK_COUNT; id++) {
+		CHECK(taken[id]);
+		CHECK(shown[id].version == chunkGenerator->chunkMeshes[id].getVersion());
+	}
+
+	// Rebuilt from scratch, every mesh has to come out exactly as the one taken last
+	for (size_t id = 0; id < CHUNK_COUNT; id++) {
+		chunkGenerator->markMeshDirty(id);
+	}
+	chunkGenerator->updateMeshes();
+
+	size_t rebuilt = 0;
+	uint32_t id;
+	ChunkMeshData data;
+	while (chunkGenerator->takeMesh(id, data)) {
+		CHECK(data.vertices == shown[id].vertices);
+		rebuilt++;
+	}
+	CHECK(rebuilt == CHUNK_COUNT);
+
+	return Check::result();
+}
@@ -0,0 +1,87 @@
+#include <core.h>
+
+#include <cstring>
+#include <vector>
+
+#include "check.h"
+
+// Every Fill*Grid kernel against the scalar Get* function at each sample, compared bit for bit
+// Counts are no multiple of 8 so the SIMD kernels also run their tails, origins are negative and between lattice points
+static const int COUNT_X = 37, COUNT_Y = 5, COUNT_Z = 6;
+
+struct Origin {
+	FN_DECIMAL x, y, z, step;
+};
+static const Origin ORIGINS[] = {
+	{ 0.0f, 0.0f, 0.0f, 1.0f },
+	{ -37.25f, 12.5f, -0.75f, 0.25f },
+	{ 1000.3f, -2000.7f, 5.1f, 3.7f },
+	{ -123456.5f, -0.125f, 77777.0f, 1.0f }
+};
+
+// Compares one grid with the scalar reference, reports the first differing sample
+template<typename Reference>
+static void compare(const std::vector<FN_DECIMAL>& grid, const Origin& origin, int countZ, const char* name, FastNoise::GridSIMD gridSIMD, Reference reference) {
+	for (int z = 0; z < countZ; z++) {
+		for (int y = 0; y < COUNT_Y; y++) {
+			for (int x = 0; x < COUNT_X; x++) {
+				FN_DECIMAL expected = reference(
+					origin.x + FN_DECIMAL(x) * origin.step,
+					origin.y + FN_DECIMAL(y) * origin.step,
+					origin.z + FN_DECIMAL(z) * origin.step
+				);
+				FN_DECIMAL actual = grid[x + y * COUNT_X + z * COUNT_X * COUNT_Y];
+
+				if (memcmp(&expected, &actual, sizeof(FN_DECIMAL)) != 0) {
+					fprintf(stderr, "%s, grid %d, origin %g %g %g: sample %d %d %d is %.9g instead of %.9g\n",
+						name, static_cast<int>(gridSIMD), origin.x, origin.y, origin.z, x, y, z, actual, expected);
+					CHECK(false);
+					return;
+				}
+			}
+		}
+	}
+}
+
+int main() {
+	const FastNoise::GridSIMD levels[] = { FastNoise::GridScalar, FastNoise::GridSSE2, FastNoise::GridAVX2 };
+	const FastNoise::Interp interps[] = { FastNoise::Linear, FastNoise::Hermite, FastNoise::Quintic };
+	std::vector<FN_DECIMAL> grid(COUNT_X * COUNT_Y * COUNT_Z);
+
+	for (int seed : { 1337, 42, -7 }) {
+		for (FN_DECIMAL frequency : { 0.01f, 0.37f }) {
+			for (FastNoise::Interp interp : interps) {
+				for (FastNoise::GridSIMD level : levels) {
+					FastNoise noise = FastNoise(seed);
+					noise.SetFrequency(frequency);
+					noise.SetInterp(interp);
+					noise.SetGridSIMD(level);
+
+					// Levels the CPU does not support are lowered and were already tested
+					if (noise.GetGridSIMD() != level) continue;
+
+					for (const Origin& origin : ORIGINS) {
+						noise.FillPerlinGrid(grid.data(), origin.x, origin.y, origin.step, origin.step, COUNT_X, COUNT_Y);
+						compare(grid, origin, 1, "FillPerlinGrid", level, [&](FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL) { return noise.GetPerlin(x, y); });
+
+						noise.FillSimplexGrid(grid.data(), origin.x, origin.y, origin.z, origin.step, origin.step, origin.step, COUNT_X, COUNT_Y, COUNT_Z);
+						compare(grid, origin, COUNT_Z, "FillSimplexGrid", level, [&](FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) { return noise.GetSimplex(x, y, z); });
+
+						noise.FillWhiteNoiseGrid(grid.data(), origin.x, origin.y, origin.step, origin.step, COUNT_X, COUNT_Y);
+						compare(grid, origin, 1, "FillWhiteNoiseGrid 2D", level, [&](FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL) { return noise.GetWhiteNoise(x, y); });
+
+						noise.FillWhiteNoiseGrid(grid.data(), origin.x, origin.y, origin.z, origin.step, origin.step, origin.step, COUNT_X, COUNT_Y, COUNT_Z);
+						compare(grid, origin, COUNT_Z, "FillWhiteNoiseGrid 3D", level, [&](FN_DECIMAL x, FN_DECIMAL y, FN_DECIMAL z) { return noise.GetWhiteNoise(x, y, z); });
+					}
+				}
+			}
+		}
+	}
+
+	// Lists the levels that ran, a machine without AVX2 only checks the others
+	FastNoise noise;
+	noise.SetGridSIMD(FastNoise::GridAVX2);
+	printf("Best grid level on this CPU: %d\n", static_cast<int>(noise.GetGridSIMD()));
+
+	return Check::result();
+}
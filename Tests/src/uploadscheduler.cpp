@@ -0,0 +1,207 @@
+#include <core.h>
+
+#include <map>
+#include <random>
+#include <thread>
+
+#include "check.h"
+
+// A mesh of vertices vertices (4 bytes each), its first vertex marks which build it is
+static ChunkMeshData createMesh(size_t vertices, uint32_t mark = 0) {
+	ChunkMeshData data;
+	data.vertices.resize(vertices, mark);
+
+	return data;
+}
+
+// Records what a frame uploaded, in order
+struct MockUploader {
+	std::vector<uint32_t> ids, marks;
+
+	UploadScheduler::Uploader get() {
+		return [this](uint32_t id, const ChunkMeshData& data) {
+			this->ids.push_back(id);
+			this->marks.push_back(data.vertices.empty() ? UINT32_MAX : data.vertices[0]);
+		};
+	}
+};
+
+static void nearestFirst() {
+	UploadScheduler uploads = UploadScheduler(64, 0, 0.0);
+	MockUploader uploader;
+
+	// Chunks 0 - 9 along x, the view in chunk 7
+	for (uint32_t id = 0; id < 10; id++) {
+		uploads.add(id, glm::ivec3(id, 0, 0), createMesh(4));
+	}
+	UploadScheduler::Stats stats = uploads.upload(glm::dvec3(7.5 * Chunk::WIDTH, 16.0, 16.0), uploader.get());
+
+	CHECK(stats.meshes == 10 && stats.bytes == 160);
+	CHECK(uploads.getPendingCount() == 0);
+	// Equally far chunks (6 and 8, 5 and 9) may go in either order
+	for (size_t i = 1; i < uploader.ids.size(); i++) {
+		CHECK(abs(static_cast<int>(uploader.ids[i]) - 7) >= abs(static_cast<int>(uploader.ids[i - 1]) - 7));
+	}
+	CHECK(uploader.ids.front() == 7 && uploader.ids.back() == 0);
+}
+
+static void byteBudget() {
+	// 1000 bytes a frame, meshes of 400 bytes and one of 200 right at the view
+	UploadScheduler uploads = UploadScheduler(64, 1000, 0.0);
+	for (uint32_t id = 0; id < 9; id++) {
+		uploads.add(id, glm::ivec3(id, 0, 0), createMesh(100));
+	}
+	uploads.add(9, glm::ivec3(9, 0, 0), createMesh(50));
+
+	glm::dvec3 viewPosition = glm::dvec3(9.5 * Chunk::WIDTH, 16.0, 16.0);
+	std::vector<size_t> meshes;
+	MockUploader uploader;
+
+	while (uploads.getPendingCount() > 0) {
+		UploadScheduler::Stats stats = uploads.upload(viewPosition, uploader.get());
+		CHECK(stats.bytes <= 1000);
+		meshes.push_back(stats.meshes);
+	}
+
+	// 200 + 400 + 400, then two of 400 a frame, the next never fits in the rest
+	CHECK(meshes == std::vector<size_t>({ 3, 2, 2, 2, 1 }));
+	CHECK(uploader.ids == std::vector<uint32_t>({ 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 }));
+
+	// Nothing pending, nothing uploaded
+	CHECK(uploads.upload(viewPosition, uploader.get()).meshes == 0);
+}
+
+static void oversizedMesh() {
+	UploadScheduler uploads = UploadScheduler(64, 1000, 0.0);
+	MockUploader uploader;
+
+	// Nearest and bigger than the whole budget, it still goes, alone
+	uploads.add(0, glm::ivec3(0), createMesh(10000));
+	uploads.add(1, glm::ivec3(1, 0, 0), createMesh(10));
+
+	UploadScheduler::Stats stats = uploads.upload(glm::dvec3(0.0), uploader.get());
+	CHECK(stats.meshes == 1 && stats.bytes == 40000);
+	CHECK(uploader.ids == std::vector<uint32_t>({ 0 }));
+
+	stats = uploads.upload(glm::dvec3(0.0), uploader.get());
+	CHECK(stats.meshes == 1 && uploads.getPendingCount() == 0);
+
+	// Behind a smaller nearer one it waits for the next frame, even if smaller ones further away would fit
+	uploads.add(2, glm::ivec3(0), createMesh(100));
+	uploads.add(3, glm::ivec3(1, 0, 0), createMesh(10000));
+	uploads.add(4, glm::ivec3(2, 0, 0), createMesh(10));
+
+	uploader.ids.clear();
+	uploads.upload(glm::dvec3(0.0), uploader.get());
+	CHECK(uploader.ids == std::vector<uint32_t>({ 2 }));
+	uploads.upload(glm::dvec3(0.0), uploader.get());
+	CHECK(uploader.ids == std::vector<uint32_t>({ 2, 3 }));
+}
+
+static void timeBudget() {
+	// 2 ms per upload against a budget of 5 ms, the frame stops at the first check after 5 ms, which is after the third upload at the latest
+	UploadScheduler uploads = UploadScheduler(64, 0, 5.0);
+	for (uint32_t id = 0; id < 20; id++) {
+		uploads.add(id, glm::ivec3(id, 0, 0), createMesh(4));
+	}
+
+	UploadScheduler::Stats stats = uploads.upload(glm::dvec3(0.0), [](uint32_t, const ChunkMeshData&) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	});
+
+	CHECK(stats.meshes >= 1 && stats.meshes <= 3);
+	CHECK(stats.milliseconds >= 5.0);
+	CHECK(uploads.getPendingCount() == 20 - stats.meshes);
+
+	// Without any budget everything goes at once
+	uploads.setTimeBudget(0.0);
+	CHECK(uploads.upload(glm::dvec3(0.0), [](uint32_t, const ChunkMeshData&) {}).meshes == 20 - stats.meshes);
+}
+
+static void replacePending() {
+	UploadScheduler uploads = UploadScheduler(64, 0, 0.0);
+	MockUploader uploader;
+
+	uploads.add(5, glm::ivec3(5, 0, 0), createMesh(4, 1));
+	uploads.add(6, glm::ivec3(6, 0, 0), createMesh(4, 1));
+	uploads.add(5, glm::ivec3(5, 0, 0), createMesh(8, 2));
+	CHECK(uploads.getPendingCount() == 2);
+
+	// Only the newest build of 5 goes, once
+	UploadScheduler::Stats stats = uploads.upload(glm::dvec3(0.0), uploader.get());
+	CHECK(stats.meshes == 2 && stats.bytes == 48);
+	CHECK(uploader.ids == std::vector<uint32_t>({ 5, 6 }));
+	CHECK(uploader.marks == std::vector<uint32_t>({ 2, 1 }));
+
+	// Uploaded ids are free again
+	uploads.add(5, glm::ivec3(5, 0, 0), createMesh(4, 3));
+	CHECK(uploads.getPendingCount() == 1);
+}
+
+// Random adds and replacements over many frames against a map of the newest build per id,
+// every frame has to upload only the newest builds, each id once, and pending has to match the map
+static void bookkeeping() {
+	const uint32_t COUNT = 300;
+	UploadScheduler uploads = UploadScheduler(COUNT, 2000, 0.0);
+	std::map<uint32_t, uint32_t> expected;
+	std::mt19937 random(25);
+	uint32_t mark = 0;
+
+	for (int frame = 0; frame < 500; frame++) {
+		int adds = frame < 450 ? random() % 12 : 0;
+		for (int i = 0; i < adds; i++) {
+			uint32_t id = random() % COUNT;
+			uploads.add(id, glm::ivec3(id % 12, id / 144, id / 12 % 12), createMesh(1 + random() % 200, ++mark));
+			expected[id] = mark;
+		}
+
+		glm::dvec3 viewPosition = glm::dvec3(random() % 384, random() % 256, random() % 384);
+		MockUploader uploader;
+		uploads.upload(viewPosition, uploader.get());
+
+		for (size_t i = 0; i < uploader.ids.size(); i++) {
+			auto found = expected.find(uploader.ids[i]);
+			CHECK(found != expected.end());
+			if (found == expected.end()) continue;
+
+			CHECK(found->second == uploader.marks[i]);
+			expected.erase(found);
+		}
+		CHECK(uploads.getPendingCount() == expected.size());
+	}
+
+	CHECK(expected.empty());
+}
+
+static void frameHistogram() {
+	FrameHistogram histogram;
+	CHECK(histogram.getFrames() == 0 && histogram.getMax() == 0.0);
+
+	// A frame right on a limit belongs to that bucket, anything above it to the next one
+	for (double milliseconds : { 0.0, 4.0, 4.001, 8.0, 16.7, 16.71, 33.3, 50.0, 100.0, 100.5, 1000.0 }) {
+		histogram.add(milliseconds);
+	}
+
+	const size_t counts[FrameHistogram::BUCKETS] = { 2, 2, 1, 2, 1, 1, 2 };
+	for (size_t bucket = 0; bucket < FrameHistogram::BUCKETS; bucket++) {
+		CHECK(histogram.getCount(bucket) == counts[bucket]);
+	}
+	CHECK(histogram.getFrames() == 11);
+	CHECK(histogram.getMax() == 1000.0);
+	CHECK(histogram.toString() == "<=4ms: 2, <=8ms: 2, <=16.7ms: 1, <=33.3ms: 2, <=50ms: 1, <=100ms: 1, >100ms: 2, max 1000.0ms");
+
+	histogram.clear();
+	CHECK(histogram.getFrames() == 0 && histogram.getCount(0) == 0 && histogram.getMax() == 0.0);
+}
+
+int main() {
+	nearestFirst();
+	byteBudget();
+	oversizedMesh();
+	timeBudget();
+	replacePending();
+	bookkeeping();
+	frameHistogram();
+
+	return Check::result();
+}
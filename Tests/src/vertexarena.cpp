@@ -0,0 +1,142 @@
+#include <core.h>
+
+#include <random>
+
+#include "check.h"
+
+static const uint32_t PAGE = VertexArena::PAGE_SIZE;
+
+static void bestFit() {
+	// Full arena of 8 pages: a 2, b 1, c 3, d 2, then a and c are freed
+	VertexArena arena = VertexArena(8 * PAGE);
+	uint32_t a = arena.allocate(2 * PAGE), b = arena.allocate(PAGE), c = arena.allocate(3 * PAGE), d = arena.allocate(2 * PAGE);
+	CHECK(d != VertexArena::INVALID && arena.getFree() == 0);
+	CHECK(arena.allocate(1) == VertexArena::INVALID);
+
+	arena.free(a);
+	arena.free(c);
+
+	// One page fits both holes, the smaller one is taken
+	uint32_t small = arena.allocate(PAGE);
+	CHECK(arena.getOffset(small) == 0);
+	uint32_t large = arena.allocate(3 * PAGE);
+	CHECK(arena.getOffset(large) == 3 * PAGE);
+	CHECK(arena.getOffset(b) == 2 * PAGE);
+}
+
+static void mergeBothSides() {
+	VertexArena arena = VertexArena(3 * PAGE);
+	uint32_t a = arena.allocate(PAGE), b = arena.allocate(PAGE), c = arena.allocate(PAGE);
+
+	arena.free(a);
+	arena.free(c);
+	CHECK(arena.getFreeRangeCount() == 2);
+
+	arena.free(b);
+	CHECK(arena.getFreeRangeCount() == 1);
+	CHECK(arena.getLargestFree() == 3 * PAGE);
+
+	// Freeing twice changes nothing
+	arena.free(b);
+	CHECK(arena.getFree() == 3 * PAGE);
+}
+
+static void idReuse() {
+	VertexArena arena = VertexArena(4 * PAGE);
+	uint32_t a = arena.allocate(10), b = arena.allocate(10);
+
+	arena.free(a);
+	uint32_t c = arena.allocate(PAGE + 1);
+	CHECK(c == a);
+	CHECK(arena.getSize(c) == PAGE + 1);
+	CHECK(arena.getOffset(b) == PAGE);
+	CHECK(arena.allocate(10) == 2);
+}
+
+static void growMergesTrailingRange() {
+	VertexArena arena = VertexArena(4 * PAGE);
+	uint32_t a = arena.allocate(3 * PAGE);
+
+	arena.grow(8 * PAGE);
+	CHECK(arena.getCapacity() == 8 * PAGE);
+	CHECK(arena.getFreeRangeCount() == 1);
+	CHECK(arena.getLargestFree() == 5 * PAGE);
+	CHECK(arena.getOffset(a) == 0);
+
+	// Smaller capacities are ignored
+	arena.grow(2 * PAGE);
+	CHECK(arena.getCapacity() == 8 * PAGE);
+}
+
+// Random allocations and frees, every allocation's vertices hold its id; defragment() is replayed into a new buffer like TerrainBuffer does:
+// the old contents are copied over as they are and every move reads from the old buffer
+static void defragmentKeepsData() {
+	std::mt19937 random(7);
+	VertexArena arena = VertexArena(64 * PAGE);
+	std::vector<uint32_t> buffer(arena.getCapacity(), UINT32_MAX);
+	std::vector<uint32_t> live;
+	size_t defragments = 0, overlapping = 0;
+
+	for (int step = 0; step < 4000; step++) {
+		if (!live.empty() && random() % 5 < 2) {
+			size_t index = random() % live.size();
+			arena.free(live[index]);
+			live[index] = live.back();
+			live.pop_back();
+
+			continue;
+		}
+
+		uint32_t size = 1 + random() % (3 * PAGE);
+		uint32_t id = arena.allocate(size);
+
+		if (id == VertexArena::INVALID) {
+			// The promise TerrainBuffer::upload relies on: with a page more than needed free in total, defragmenting always makes room
+			if (arena.getFree() < size + PAGE) continue;
+
+			std::vector<VertexArena::Move> moves = arena.defragment();
+			CHECK(arena.getFreeRangeCount() <= 1);
+			CHECK(arena.getLargestFree() == arena.getFree());
+
+			std::vector<uint32_t> moved = buffer;
+			for (const VertexArena::Move& move : moves) {
+				CHECK(move.to < move.from);
+				if (move.to + move.size > move.from) overlapping++;
+
+				std::copy(buffer.begin() + move.from, buffer.begin() + move.from + move.size, moved.begin() + move.to);
+			}
+			buffer = moved;
+			defragments++;
+
+			id = arena.allocate(size);
+			CHECK(id != VertexArena::INVALID);
+			if (id == VertexArena::INVALID) continue;
+		}
+
+		std::fill(buffer.begin() + arena.getOffset(id), buffer.begin() + arena.getOffset(id) + size, id);
+		live.push_back(id);
+
+		for (uint32_t other : live) {
+			for (uint32_t vertex = 0; vertex < arena.getSize(other); vertex++) {
+				if (buffer[arena.getOffset(other) + vertex] != other) {
+					CHECK(buffer[arena.getOffset(other) + vertex] == other);
+					break;
+				}
+			}
+		}
+	}
+
+	// The sequence has to actually exercise defragment(), including moves onto their own source
+	CHECK(defragments > 10);
+	CHECK(overlapping > 0);
+}
+
+int main() {
+	bestFit();
+	mergeBothSides();
+	idReuse();
+	growMergesTrailingRange();
+	defragmentKeepsData();
+
+	return Check::result();
+}
@@ -0,0 +1,42 @@
+#include <core.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Regenerates the world of a golden hash file and fails on every chunk that came out different
+// After an intended change to the terrain, the file is written again with --save <file> [seed]
+int main(int argc, char** argv) {
+	if (argc > 2 && strcmp(argv[1], "--save") == 0) {
+		int seed = argc > 3 ? atoi(argv[3]) : WorldHashes::DEFAULT_SEED;
+		if (!WorldHashes::save(argv[2], seed)) {
+			fprintf(stderr, "Failed to write %s\n", argv[2]);
+			return 1;
+		}
+
+		printf("Saved the chunk hashes of seed %d to %s\n", seed, argv[2]);
+		return 0;
+	}
+	if (argc != 2) {
+		fprintf(stderr, "Usage: %s <file> | --save <file> [seed]\n", argv[0]);
+		return 1;
+	}
+
+	WorldHashes::Report report;
+	if (!WorldHashes::verify(argv[1], report)) {
+		fprintf(stderr, "%s is no world hash file or lists no chunk\n", argv[1]);
+		return 1;
+	}
+
+	for (const WorldHashes::Mismatch& mismatch : report.mismatches) {
+		fprintf(stderr, "Chunk %d %d %d: expected %016llx, got %016llx\n", mismatch.position.x, mismatch.position.y, mismatch.position.z,
+			static_cast<unsigned long long>(mismatch.expected), static_cast<unsigned long long>(mismatch.actual));
+	}
+	if (!report.mismatches.empty()) {
+		fprintf(stderr, "%zu of %zu chunks differ for seed %d\n", report.mismatches.size(), report.checked, report.seed);
+		return 1;
+	}
+
+	printf("All %zu chunks match for seed %d\n", report.checked, report.seed);
+	return 0;
+}